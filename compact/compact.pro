@@ -5,6 +5,9 @@ DEFINES += COMPACT_LIBRARY
 
 CONFIG += c++11
 
+# asserts guard trusted fast paths in debug builds only
+CONFIG(release, debug|release): DEFINES += NDEBUG
+
 # The following define makes your compiler emit warnings if you use
 # any Qt feature that has been marked deprecated (the exact warnings
 # depend on your compiler). Please consult the documentation of the
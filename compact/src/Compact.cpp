@@ -1,6 +1,7 @@
 #include <string.h>
 #include <string>
 #include <cmath>
+#include <cassert>
 
 #include "../include/ICompact.h"
 #include "../include/IVector.h"
@@ -192,7 +193,21 @@ bool checkLess(IVector const * left, IVector const * right, const char * during,
         return false;
     }
 
-    for(size_t i = 0; i < left->getDim(); ++i) {
+    size_t dim = left->getDim();
+    double const * leftData = left->getData();
+    double const * rightData = right->getData();
+
+    if(leftData != nullptr && rightData != nullptr) {
+        bool less = true;
+
+        for(size_t i = 0; i < dim; ++i) {
+            less &= leftData[i] <= rightData[i];
+        }
+
+        return less;
+    }
+
+    for(size_t i = 0; i < dim; ++i) {
         if(left->getCoord(i) > right->getCoord(i)) {
             return false;
         }
@@ -262,18 +277,6 @@ bool checkUnique(IVector const * const vector, size_t idx) {
     return true;
 }
 
-bool hasNaNCoord(IVector * vector, char const * during, ILogger * pLogger) {
-    for(size_t i = 0; i < vector->getDim(); ++i) {
-        if(std::isnan(vector->getCoord(i))) {
-            Loggable::printLogDuring("Passed vector with NaN coordinate", during, RESULT_CODE::NAN_VALUE, pLogger);
-
-            return true;
-        }
-    }
-
-    return false;
-}
-
 
 
 /* ICompact */
@@ -304,14 +307,8 @@ Compact * Compact::createCompact(IVector const * const begin, IVector const * co
         return nullptr;
     }
 
-    auto clonedBegin = const_cast <IVector *> (begin)->clone();
-
-    if(hasNaNCoord(clonedBegin, during, logger)) {
-        delete clonedBegin;
-        clonedBegin = nullptr;
-
-        return nullptr;
-    }
+    //clones of valid vectors are valid, so they are checked for NaN in debug builds only
+    auto clonedBegin = begin->clone();
 
     if(clonedBegin == nullptr) {
         printLogDuring("Failed to clone vector", during, RESULT_CODE::OUT_OF_MEMORY, logger);
@@ -319,24 +316,21 @@ Compact * Compact::createCompact(IVector const * const begin, IVector const * co
         return nullptr;
     }
 
-    auto clonedEnd = const_cast <IVector *> (end)->clone();
+    assert(!IVector::hasNaN(clonedBegin->getData(), clonedBegin->getDim()));
 
-    if(hasNaNCoord(clonedEnd, during, logger)) {
-        delete clonedBegin;
-        delete clonedEnd;
-
-        clonedBegin = nullptr;
-        clonedEnd = nullptr;
-
-        return nullptr;
-    }
+    auto clonedEnd = end->clone();
 
     if(clonedEnd == nullptr) {
         printLogDuring("Failed to clone vector", during, RESULT_CODE::OUT_OF_MEMORY, logger);
 
+        delete clonedBegin;
+        clonedBegin = nullptr;
+
         return nullptr;
     }
 
+    assert(!IVector::hasNaN(clonedEnd->getData(), clonedEnd->getDim()));
+
     Compact * compact = new Compact(clonedBegin, clonedEnd, logger);
 
     if(compact == nullptr) {
@@ -790,17 +784,16 @@ RESULT_CODE Compact::Iterator::doStep() {
     char const * during = "ICompact::iterator::doStep";
     IVector * begin = compact->getBegin();
     IVector * end = compact->getEnd();
-    bool equalsBool;
-    RESULT_CODE equalsResult;
+    double distance;
 
     if(!reverse) {
-        equalsResult = IVector::equals(end, current, IVector::NORM::NORM_2, TOLERANCE, &equalsBool, logger);
+        distance = IVector::distance(end, current, IVector::NORM::NORM_2, logger);
     }
     else {
-        equalsResult = IVector::equals(begin, current, IVector::NORM::NORM_2, TOLERANCE, &equalsBool, logger);
+        distance = IVector::distance(begin, current, IVector::NORM::NORM_2, logger);
     }
 
-    if(equalsBool || equalsResult != RESULT_CODE::SUCCESS) {
+    if(std::isnan(distance) || distance <= TOLERANCE) {
         delete begin;
         delete end;
 
@@ -0,0 +1,43 @@
+#ifndef IMATRIX_H
+#define IMATRIX_H
+
+#include<stddef.h>
+#include "IVector.h"
+#include "IVectorBatch.h"
+
+/* affine map x -> A x + b with a rows x cols matrix A stored row by row and an optional translation b of rows coordinates */
+class IMatrix {
+public:
+    //pData holds rows * cols coordinates, pTranslation is nullptr for a linear map
+    static IMatrix* createMatrix(size_t rows, size_t cols, double const* pData, double const* pTranslation, ILogger* pLogger);
+    static IMatrix* createIdentity(size_t dim, ILogger* pLogger);
+    virtual ~IMatrix() = 0;
+    virtual IMatrix* clone() const = 0;
+
+    virtual size_t getRows() const = 0;
+    virtual size_t getCols() const = 0;
+    virtual double getCoord(size_t row, size_t col) const = 0;
+    virtual RESULT_CODE setCoord(size_t row, size_t col, double value) = 0;
+    virtual double const* getData() const = 0;
+    //nullptr for a linear map
+    virtual double const* getTranslation() const = 0;
+    //nullptr removes the translation
+    virtual RESULT_CODE setTranslation(double const* pTranslation) = 0;
+
+    //the map pOperand1 applied after pOperand2
+    static IMatrix* mul(IMatrix const* pOperand1, IMatrix const* pOperand2, ILogger* pLogger);
+    //pVector has getCols() coordinates, the result getRows()
+    static IVector* mul(IMatrix const* pMatrix, IVector const* pVector, ILogger* pLogger);
+    /* every vector of pBatch, block by block with the matrix rows kept in registers and split between threads for large batches;
+       pResult has the count of pBatch and getRows() dimension and may be pBatch itself for square matrices;
+       CALCULATION_ERROR leaves pResult unchanged when a NaN coordinate would be obtained */
+    static RESULT_CODE mul(IMatrix const* pMatrix, IVectorBatch const* pBatch, IVectorBatch* pResult, ILogger* pLogger);
+    static RESULT_CODE transform(IMatrix const* pMatrix, IVectorBatch* pBatch, ILogger* pLogger);
+protected:
+    IMatrix() = default;
+private:
+    IMatrix(IMatrix const& matrix) = delete;
+    IMatrix& operator=(IMatrix const& matrix) = delete;
+};
+
+#endif // IMATRIX_H
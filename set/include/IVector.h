@@ -5,6 +5,9 @@
 #include<stddef.h>
 #include "ILogger.h"
 
+class IVectorArena;
+class INorm;
+
 
 
 
@@ -18,17 +21,67 @@ public:
         NORM_INF
     };
     static IVector* createVector(size_t dim, double* pData, ILogger* pLogger);
+    //vector memory is taken from the arena and returned when the arena is reset
+    static IVector* createVector(size_t dim, double* pData, ILogger* pLogger, IVectorArena* pArena);
+    //pData is known to have no NaN: it is asserted in debug builds and not checked at all in release ones
+    static IVector* createTrustedVector(size_t dim, double const* pData, ILogger* pLogger);
+    static IVector* createTrustedVector(size_t dim, double const* pData, ILogger* pLogger, IVectorArena* pArena);
+    //vectorized check of raw coordinates, false for nullptr
+    static bool hasNaN(double const* pData, size_t dim);
+    //coordinates are stored in single precision, calculations are still carried out in double precision
+    static IVector* createFloatVector(size_t dim, float const* pData, ILogger* pLogger);
+    static IVector* createFloatVector(size_t dim, float const* pData, ILogger* pLogger, IVectorArena* pArena);
+    //only the count coordinates at pIndices, which must be strictly increasing, are stored; the others are zero
+    static IVector* createSparseVector(size_t dim, size_t count, size_t const* pIndices, double const* pValues, ILogger* pLogger);
+    //borrows pData without copying or checking it for NaN, the buffer must outlive the view; clones own their coordinates
+    static IVector* createView(size_t dim, double* pData, ILogger* pLogger);
+    //the same, setCoord fails and getMutableData returns nullptr
+    static IVector* createReadOnlyView(size_t dim, double const* pData, ILogger* pLogger);
     virtual ~IVector() = 0;
     virtual IVector* clone() const = 0;
+    virtual IVector* clone(IVectorArena* pArena) const = 0;
     static IVector* add(IVector const* pOperand1, IVector const* pOperand2, ILogger* pLogger);
     static IVector* sub(IVector const* pOperand1, IVector const* pOperand2, ILogger* pLogger);
     static IVector* mul(IVector const* pOperand1, double scaleParam, ILogger* pLogger);
     static double mul(IVector const* pOperand1, IVector const* pOperand2, ILogger* pLogger);
+
+    /* allocation-free forms, pResult must already have the operands dimension;
+       CALCULATION_ERROR leaves it unchanged when a NaN coordinate would be obtained, which is ruled out by the maximum norms;
+       long results keep theirs from the write, views have no cache and are read once more for them */
+    static RESULT_CODE add(IVector const* pOperand1, IVector const* pOperand2, IVector* pResult, ILogger* pLogger);
+    static RESULT_CODE sub(IVector const* pOperand1, IVector const* pOperand2, IVector* pResult, ILogger* pLogger);
+    static RESULT_CODE mul(IVector const* pOperand1, double scaleParam, IVector* pResult, ILogger* pLogger);
+    static RESULT_CODE addInPlace(IVector* pOperand1, IVector const* pOperand2, ILogger* pLogger);
+    static RESULT_CODE subInPlace(IVector* pOperand1, IVector const* pOperand2, ILogger* pLogger);
+    static RESULT_CODE scaleInPlace(IVector* pOperand1, double scaleParam, ILogger* pLogger);
+    //pY += a * pX
+    static RESULT_CODE axpy(IVector* pY, double a, IVector const* pX, ILogger* pLogger);
+
+    //norm of the difference without temporaries, NaN on error
+    static double distance(IVector const* pOperand1, IVector const* pOperand2, NORM norm, ILogger* pLogger);
     static RESULT_CODE equals(IVector const* pOperand1, IVector const* pOperand2, NORM norm, double tolerance, bool* result, ILogger* pLogger);
+    //same answer as equals, but stops as soon as the tolerance is exceeded
+    static RESULT_CODE withinTolerance(IVector const* pOperand1, IVector const* pOperand2, NORM norm, double tolerance, bool* result, ILogger* pLogger);
+    //the same with weighted and general Lp norms, the standard ones among them take the paths above
+    static double distance(IVector const* pOperand1, IVector const* pOperand2, INorm const* pNorm, ILogger* pLogger);
+    static RESULT_CODE equals(IVector const* pOperand1, IVector const* pOperand2, INorm const* pNorm, double tolerance, bool* result, ILogger* pLogger);
+    static RESULT_CODE withinTolerance(IVector const* pOperand1, IVector const* pOperand2, INorm const* pNorm, double tolerance, bool* result, ILogger* pLogger);
+    //norm, dot, distance and linear combinations of vectors with at least dim coordinates are split between threads;
+    //their partial sums are then taken over fixed chunks, so results do not depend on the number of threads
+    static void setParallelThreshold(size_t dim);
+    static size_t getParallelThreshold();
+    //checks every SIMD backend supported by the CPU against the scalar one
+    static RESULT_CODE selfTest(ILogger* pLogger);
     virtual double getCoord(size_t index)const = 0;
     virtual RESULT_CODE setCoord(size_t index, double value) = 0;
+    //vectors owning more than a cache line of coordinates keep each norm until setCoord, so indexes may call it freely;
+    //once getMutableData was called on a vector, its norms are computed on every call
     virtual double norm(NORM norm) const= 0;
     virtual size_t getDim() const = 0;
+    //contiguous coordinates for tight loops, nullptr if the vector does not keep them as one array of doubles
+    virtual double const* getData() const = 0;
+    //the same for writing, storing NaN through it is not allowed; it stays valid as long as the vector
+    virtual double* getMutableData() = 0;
 protected:
     IVector() = default;
 private:
@@ -0,0 +1,55 @@
+#ifndef IVECTORBATCH_H
+#define IVECTORBATCH_H
+
+#include<stddef.h>
+#include "IVector.h"
+
+/* count vectors of one dimension in one aligned buffer, interleaved by blocks of LANES vectors:
+   coordinate j of vector i is stored at [(i / LANES * dim + j) * LANES + i % LANES], unused lanes of the last block are zero */
+class IVectorBatch {
+public:
+    static size_t const LANES = 8;
+
+    //zero vectors
+    static IVectorBatch* createBatch(size_t count, size_t dim, ILogger* pLogger);
+    virtual ~IVectorBatch() = 0;
+    virtual IVectorBatch* clone() const = 0;
+
+    virtual size_t getCount() const = 0;
+    virtual size_t getDim() const = 0;
+    virtual double getCoord(size_t index, size_t coord) const = 0;
+    virtual RESULT_CODE setCoord(size_t index, size_t coord, double value) = 0;
+    virtual RESULT_CODE setVector(size_t index, IVector const* pVector) = 0;
+    //IVector over one vector of the batch, writes go to the batch; the view must not outlive it
+    virtual IVector* createView(size_t index) = 0;
+    //interleaved coordinates, storing NaN through getMutableData is not allowed
+    virtual double const* getData() const = 0;
+    virtual double* getMutableData() = 0;
+
+    /* element-wise over all vectors, pResult must have the operands count and dimension and may alias them */
+    static RESULT_CODE add(IVectorBatch const* pOperand1, IVectorBatch const* pOperand2, IVectorBatch* pResult, ILogger* pLogger);
+    static RESULT_CODE sub(IVectorBatch const* pOperand1, IVectorBatch const* pOperand2, IVectorBatch* pResult, ILogger* pLogger);
+    static RESULT_CODE mul(IVectorBatch const* pOperand1, double scaleParam, IVectorBatch* pResult, ILogger* pLogger);
+
+    /* one result per vector of the batch is written to pResults */
+    static RESULT_CODE mul(IVectorBatch const* pBatch, IVector const* pQuery, double* pResults, ILogger* pLogger);
+    static RESULT_CODE norm(IVectorBatch const* pBatch, IVector::NORM norm, double* pResults, ILogger* pLogger);
+    static RESULT_CODE distance(IVectorBatch const* pBatch, IVector const* pQuery, IVector::NORM norm, double* pResults, ILogger* pLogger);
+
+    /* distances between every vector of pRows and every vector of pColumns, cache-blocked and split between threads;
+       NORM_2 is computed as sqrt(|a|^2 + |b|^2 - 2ab), so its absolute error is up to about sqrt((dim + 2) ulps of |a|^2 + |b|^2):
+       with norms of 1e4, distances below about 1e-3 are not resolved and may come out as 0 */
+    //pMatrix[i * pColumns->getCount() + j] is the distance between vector i of pRows and vector j of pColumns
+    static RESULT_CODE distanceMatrix(IVectorBatch const* pRows, IVectorBatch const* pColumns, IVector::NORM norm, double* pMatrix, ILogger* pLogger);
+    /* pCallback receives the pairs at distance <= threshold, or > threshold if below is false, in row-major order on the calling thread;
+       NORM_2 pairs within the error above of the threshold are computed again from the coordinates, so the selection agrees with the direct distance */
+    static RESULT_CODE selectDistances(IVectorBatch const* pRows, IVectorBatch const* pColumns, IVector::NORM norm, double threshold, bool below,
+                                       void (*pCallback)(size_t row, size_t column, double distance, void* pContext), void* pContext, ILogger* pLogger);
+protected:
+    IVectorBatch() = default;
+private:
+    IVectorBatch(IVectorBatch const& batch) = delete;
+    IVectorBatch& operator=(IVectorBatch const& batch) = delete;
+};
+
+#endif // IVECTORBATCH_H
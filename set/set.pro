@@ -24,8 +24,11 @@ LIBS += \
 
 HEADERS += \
     include/ILogger.h \
+    include/IMatrix.h \
+    include/INorm.h \
     include/ISet.h \
     include/IVector.h \
+    include/IVectorBatch.h \
     include/RC.h
 
 # Default rules for deployment.
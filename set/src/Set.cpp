@@ -5,12 +5,17 @@
 #include <algorithm>
 
 #include "../include/ISet.h"
+#include "../include/IMatrix.h"
+#include "../include/INorm.h"
 
 
 
 namespace {
 typedef std::vector <IVector const *>::iterator setIterator;
 
+//relative error allowed to the norms compared by the triangle inequality
+double const PRUNING_SLACK = 1e-9;
+
 class Loggable {
 public:
     explicit Loggable(ILogger * pLogger);
@@ -33,14 +38,18 @@ class Set : public ISet, private Loggable {
 public:
     ~Set() override;
     RESULT_CODE insert(const IVector * pVector, IVector::NORM norm, double tolerance) override;
+    RESULT_CODE insert(IVector const * pVector, INorm const * pNorm, double tolerance) override;
     RESULT_CODE get(IVector * & pVector, size_t index) const override;
     RESULT_CODE get(IVector * & pVector, IVector const * pSample, IVector::NORM norm, double tolerance) const override;
+    RESULT_CODE get(IVector * & pVector, IVector const * pSample, INorm const * pNorm, double tolerance) const override;
     size_t getDim() const override;
     size_t getSize() const override;
     void clear() override;
     RESULT_CODE erase(size_t index) override;
     RESULT_CODE erase(IVector const * pSample, IVector::NORM norm, double tolerance) override;
+    RESULT_CODE erase(IVector const * pSample, INorm const * pNorm, double tolerance) override;
     ISet * clone() const override;
+    RESULT_CODE transform(IMatrix const * pMatrix, IVector::NORM norm, double tolerance) override;
 
     static Set * createSet(ILogger * pLogger);
 
@@ -49,7 +58,15 @@ private:
     Set(Set const & anotherSet) = delete;
     Set & operator = (Set const & anotherSet) = delete;
 
-    setIterator findFirstClosest(IVector const * pSample, IVector::NORM norm, double tolerance) const;
+    //Norm is IVector::NORM or INorm const *
+    template <typename Norm>
+    RESULT_CODE insertWithNorm(IVector const * pVector, Norm norm, double tolerance);
+    template <typename Norm>
+    RESULT_CODE getWithNorm(IVector * & pVector, IVector const * pSample, Norm norm, double tolerance) const;
+    template <typename Norm>
+    RESULT_CODE eraseWithNorm(IVector const * pSample, Norm norm, double tolerance);
+    template <typename Norm>
+    setIterator findFirstClosest(IVector const * pSample, Norm norm, double tolerance) const;
     void insert(const IVector * pVector);
 
     mutable std::vector <IVector const *> set;
@@ -144,6 +161,62 @@ bool equalDims(ISet const * pOperand1, ISet const * pOperand2, char const * duri
 }
 
 
+/* standard norms are checked where they are used, weighted ones must match the dimension unless it is 0 */
+RESULT_CODE checkNorm(IVector::NORM, size_t, char const *, ILogger *) {
+    return RESULT_CODE::SUCCESS;
+}
+
+RESULT_CODE checkNorm(INorm const * pNorm, size_t dim, char const * during, ILogger * pLogger) {
+    if(pNorm == nullptr) {
+        return Loggable::printLogDuring("Passed a norm with a null pointer", during, RESULT_CODE::BAD_REFERENCE,
+                                        pLogger);
+    }
+
+    if(pNorm->getDim() != 0 && dim != 0 && pNorm->getDim() != dim) {
+        return Loggable::printLogDuring("Weighted norm and vector dimensions are not equal", during,
+                                        RESULT_CODE::WRONG_DIM, pLogger);
+    }
+
+    return RESULT_CODE::SUCCESS;
+}
+
+/* vector index of an interleaved batch written into pVector; setCoord rather than getMutableData, which would stop
+   the vector from caching the norms the searches prune with */
+RESULT_CODE storeBatchVector(IVector * pVector, IVectorBatch const * pBatch, size_t index) {
+    size_t const LANES = IVectorBatch::LANES;
+    size_t dim = pBatch->getDim();
+    double const * data = pBatch->getData();
+    RESULT_CODE code = RESULT_CODE::SUCCESS;
+
+    for(size_t j = 0; j < dim && code == RESULT_CODE::SUCCESS; ++j) {
+        code = pVector->setCoord(j, data[(index / LANES * dim + j) * LANES + index % LANES]);
+    }
+
+    return code;
+}
+
+/* selectDistances callback setting the bool at pContext for a pair of different vectors */
+void markCollision(size_t row, size_t column, double, void * pContext) {
+    if(row != column) {
+        *(bool *) pContext = true;
+    }
+}
+
+/* the norm as one of those the vectors keep cached, false if it is none of them */
+bool cachedNorm(IVector::NORM norm, IVector::NORM & cached) {
+    cached = norm;
+
+    return norm == IVector::NORM::NORM_1 || norm == IVector::NORM::NORM_2 || norm == IVector::NORM::NORM_INF;
+}
+
+bool cachedNorm(INorm const * pNorm, IVector::NORM & cached) {
+    double p = pNorm->getP();
+
+    cached = p == 1. ? IVector::NORM::NORM_1 : p == 2. ? IVector::NORM::NORM_2 : IVector::NORM::NORM_INF;
+
+    return pNorm->getWeights() == nullptr && (p == 1. || p == 2. || std::isinf(p));
+}
+
 
 /* ISet */
 
@@ -178,7 +251,8 @@ void Set::insert(const IVector * pVector) {
     set.push_back(pVector);
 }
 
-RESULT_CODE Set::insert(IVector const * pVector, IVector::NORM norm, double tolerance) {
+template <typename Norm>
+RESULT_CODE Set::insertWithNorm(IVector const * pVector, Norm norm, double tolerance) {
     char const * during = "ISet::insert";
 
     if(pVector == nullptr) {
@@ -197,6 +271,12 @@ RESULT_CODE Set::insert(IVector const * pVector, IVector::NORM norm, double tole
         return printLogDuring("Vector and set dimensions are not equal", during, RESULT_CODE::WRONG_DIM, logger);
     }
 
+    RESULT_CODE code = checkNorm(norm, pVector->getDim(), during, logger);
+
+    if(code != RESULT_CODE::SUCCESS) {
+        return code;
+    }
+
     setIterator it = findFirstClosest(pVector, norm, tolerance);
 
     if(it != set.end()) {
@@ -214,6 +294,14 @@ RESULT_CODE Set::insert(IVector const * pVector, IVector::NORM norm, double tole
     return RESULT_CODE::SUCCESS;
 }
 
+RESULT_CODE Set::insert(IVector const * pVector, IVector::NORM norm, double tolerance) {
+    return insertWithNorm(pVector, norm, tolerance);
+}
+
+RESULT_CODE Set::insert(IVector const * pVector, INorm const * pNorm, double tolerance) {
+    return insertWithNorm(pVector, pNorm, tolerance);
+}
+
 RESULT_CODE Set::get(IVector * & pVector, size_t index) const {
     char const * during = "ISet::get";
 
@@ -232,7 +320,8 @@ RESULT_CODE Set::get(IVector * & pVector, size_t index) const {
     return RESULT_CODE::SUCCESS;
 }
 
-RESULT_CODE Set::get(IVector * & pVector, IVector const * pSample, IVector::NORM norm, double tolerance) const {
+template <typename Norm>
+RESULT_CODE Set::getWithNorm(IVector * & pVector, IVector const * pSample, Norm norm, double tolerance) const {
     char const * during = "ISet::get";
 
     if(pSample == nullptr) {
@@ -251,6 +340,12 @@ RESULT_CODE Set::get(IVector * & pVector, IVector const * pSample, IVector::NORM
         return printLogDuring("Vector and set dimensions are not equal", during, RESULT_CODE::WRONG_DIM, logger);
     }
 
+    RESULT_CODE code = checkNorm(norm, pSample->getDim(), during, logger);
+
+    if(code != RESULT_CODE::SUCCESS) {
+        return code;
+    }
+
     setIterator it = findFirstClosest(pSample, norm, tolerance);
 
     if(it == set.end()) {
@@ -268,6 +363,14 @@ RESULT_CODE Set::get(IVector * & pVector, IVector const * pSample, IVector::NORM
     return RESULT_CODE::SUCCESS;
 }
 
+RESULT_CODE Set::get(IVector * & pVector, IVector const * pSample, IVector::NORM norm, double tolerance) const {
+    return getWithNorm(pVector, pSample, norm, tolerance);
+}
+
+RESULT_CODE Set::get(IVector * & pVector, IVector const * pSample, INorm const * pNorm, double tolerance) const {
+    return getWithNorm(pVector, pSample, pNorm, tolerance);
+}
+
 size_t Set::getDim() const {
     if(set.empty()) {
         return 0;
@@ -305,7 +408,8 @@ RESULT_CODE Set::erase(size_t index) {
     return RESULT_CODE::SUCCESS;
 }
 
-RESULT_CODE Set::erase(IVector const * pSample, IVector::NORM norm, double tolerance) {
+template <typename Norm>
+RESULT_CODE Set::eraseWithNorm(IVector const * pSample, Norm norm, double tolerance) {
     char const * during = "ISet::erase";
 
     if(pSample == nullptr) {
@@ -324,6 +428,12 @@ RESULT_CODE Set::erase(IVector const * pSample, IVector::NORM norm, double toler
         return printLogDuring("Vector and set dimensions are not equal", during, RESULT_CODE::WRONG_DIM, logger);
     }
 
+    RESULT_CODE code = checkNorm(norm, pSample->getDim(), during, logger);
+
+    if(code != RESULT_CODE::SUCCESS) {
+        return code;
+    }
+
     setIterator it = findFirstClosest(pSample, norm, tolerance);
 
     if(it == set.end()) {
@@ -337,6 +447,14 @@ RESULT_CODE Set::erase(IVector const * pSample, IVector::NORM norm, double toler
     return RESULT_CODE::SUCCESS;
 }
 
+RESULT_CODE Set::erase(IVector const * pSample, IVector::NORM norm, double tolerance) {
+    return eraseWithNorm(pSample, norm, tolerance);
+}
+
+RESULT_CODE Set::erase(IVector const * pSample, INorm const * pNorm, double tolerance) {
+    return eraseWithNorm(pSample, pNorm, tolerance);
+}
+
 ISet * Set::clone() const {
     char const * during = "ISet::clone";
     Set * copy = Set::createSet(logger);
@@ -363,18 +481,125 @@ ISet * Set::clone() const {
     return copy;
 }
 
-setIterator Set::findFirstClosest(IVector const * pSample, IVector::NORM norm, double tolerance) const {
+RESULT_CODE Set::transform(IMatrix const * pMatrix, IVector::NORM norm, double tolerance) {
+    char const * during = "ISet::transform";
+
+    if(pMatrix == nullptr) {
+        return printLogDuring("Passed a matrix with a null pointer", during, RESULT_CODE::BAD_REFERENCE, logger);
+    }
+
+    if(std::isnan(tolerance)) {
+        return printLogDuring("Tolerance equal to NaN is passed", during, RESULT_CODE::NAN_VALUE, logger);
+    }
+
+    if(tolerance < 0) {
+        return printLogDuring("Tolerance less than zero is passed", during, RESULT_CODE::WRONG_ARGUMENT, logger);
+    }
+
+    if(set.empty()) {
+        return RESULT_CODE::SUCCESS;
+    }
+
+    size_t dim = getDim();
+
+    if(pMatrix->getRows() != dim || pMatrix->getCols() != dim) {
+        return printLogDuring("Matrix and set dimensions are not equal", during, RESULT_CODE::WRONG_DIM, logger);
+    }
+
+    //the vectors are gathered so that the whole set is one batched product, the copy restores them on failure
+    IVectorBatch * batch = IVectorBatch::createBatch(set.size(), dim, logger);
+    IVectorBatch * original = nullptr;
+    RESULT_CODE code = batch == nullptr ? RESULT_CODE::OUT_OF_MEMORY : RESULT_CODE::SUCCESS;
+
+    for(size_t i = 0; i < set.size() && code == RESULT_CODE::SUCCESS; ++i) {
+        code = batch->setVector(i, set[i]);
+    }
+
+    if(code == RESULT_CODE::SUCCESS) {
+        original = batch->clone();
+        code = original == nullptr ? RESULT_CODE::OUT_OF_MEMORY : IMatrix::transform(pMatrix, batch, logger);
+    }
+
+    //a contracting or singular matrix may bring two vectors within the tolerance, which the set does not allow
+    bool collision = false;
+
+    if(code == RESULT_CODE::SUCCESS) {
+        code = IVectorBatch::selectDistances(batch, batch, norm, tolerance, true, markCollision, &collision, logger);
+    }
+
+    if(code == RESULT_CODE::SUCCESS && collision) {
+        code = printLogDuring("Images of two vectors are within the tolerance, the set is left unchanged", during,
+                              RESULT_CODE::MULTIPLE_DEFINITION, logger);
+    }
+
+    if(code != RESULT_CODE::SUCCESS) {
+        delete batch;
+        delete original;
+
+        batch = nullptr;
+        original = nullptr;
+
+        return code == RESULT_CODE::OUT_OF_MEMORY ?
+                    printLogDuring("Not enough memory to transform the set", during, code, logger) : code;
+    }
+
+    size_t stored = 0;
+
+    //vectors of the set are its own clones
+    for(; stored < set.size() && code == RESULT_CODE::SUCCESS; ++stored) {
+        code = storeBatchVector(const_cast <IVector *> (set[stored]), batch, stored);
+    }
+
+    if(code != RESULT_CODE::SUCCESS) {
+        bool restored = true;
+
+        //coordinates written before keep their storage, so they are stored back without allocating
+        for(size_t i = 0; i < stored; ++i) {
+            restored &= storeBatchVector(const_cast <IVector *> (set[i]), original, i) == RESULT_CODE::SUCCESS;
+        }
+
+        printLogDuring(restored ? "Failed to store a transformed vector, the set is left unchanged" :
+                                  "Failed to store a transformed vector, the set is left partially transformed",
+                       during, code, logger);
+    }
+
+    delete batch;
+    delete original;
+
+    batch = nullptr;
+    original = nullptr;
+
+    return code;
+}
+
+template <typename Norm>
+setIterator Set::findFirstClosest(IVector const * pSample, Norm norm, double tolerance) const {
     setIterator const ERROR = set.end();
 
     if(pSample == nullptr || std::isnan(tolerance) || tolerance < 0 || pSample->getDim() != getDim()) {
         return ERROR;
     }
 
+    //|norm(a) - norm(b)| <= norm(a - b), so vectors with far norms are skipped; stored vectors keep their norms cached
+    IVector::NORM cached = IVector::NORM::NORM_2;
+    bool prune = cachedNorm(norm, cached);
+    double sampleNorm = prune ? pSample->norm(cached) : 0.;
+
     for(setIterator it = set.begin(); it != set.end(); ++it) {
+        if(prune) {
+            double vectorNorm = (*it)->norm(cached);
+            //norms are rounded, the slack keeps the pruning from rejecting vectors that are within tolerance
+            double slack = PRUNING_SLACK * (sampleNorm + vectorNorm);
+
+            if(std::fabs(sampleNorm - vectorNorm) > tolerance + slack) {
+                continue;
+            }
+        }
+
         bool result = false;
-        RESULT_CODE equalsResult = IVector::equals(pSample, *it, norm, tolerance, &result, logger);
+        RESULT_CODE withinResult = IVector::withinTolerance(pSample, *it, norm, tolerance, &result, logger);
 
-        if(equalsResult == RESULT_CODE::SUCCESS && result) {
+        if(withinResult == RESULT_CODE::SUCCESS && result) {
             return it;
         }
     }
@@ -382,9 +607,13 @@ setIterator Set::findFirstClosest(IVector const * pSample, IVector::NORM norm, d
     return ERROR;
 }
 
-ISet * ISet::add(
-        ISet const * pOperand1, ISet const * pOperand2, IVector::NORM norm, double tolerance, ILogger * pLogger
-        ) {
+
+
+namespace {
+/* set operations for both kinds of norms, Norm is IVector::NORM or INorm const * */
+
+template <typename Norm>
+ISet * addSets(ISet const * pOperand1, ISet const * pOperand2, Norm norm, double tolerance, ILogger * pLogger) {
     char const * during = "ISet::add";
 
     if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger) || !equalDims(pOperand1, pOperand2, during, pLogger)) {
@@ -403,6 +632,10 @@ ISet * ISet::add(
         return nullptr;
     }
 
+    if(checkNorm(norm, pOperand1->getDim(), during, pLogger) != RESULT_CODE::SUCCESS) {
+        return nullptr;
+    }
+
     ISet * sum = pOperand1->clone();
 
     if(sum == nullptr) {
@@ -424,9 +657,8 @@ ISet * ISet::add(
     return sum;
 }
 
-ISet * ISet::intersect(
-        ISet const * pOperand1, ISet const * pOperand2, IVector::NORM norm, double tolerance, ILogger * pLogger
-        ) {
+template <typename Norm>
+ISet * intersectSets(ISet const * pOperand1, ISet const * pOperand2, Norm norm, double tolerance, ILogger * pLogger) {
     char const * during = "ISet::intersect";
 
     if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger) || !equalDims(pOperand1, pOperand2, during, pLogger)) {
@@ -445,6 +677,10 @@ ISet * ISet::intersect(
         return nullptr;
     }
 
+    if(checkNorm(norm, pOperand1->getDim(), during, pLogger) != RESULT_CODE::SUCCESS) {
+        return nullptr;
+    }
+
     ISet * intersection = ISet::createSet(pLogger);
 
     if(intersection == nullptr) {
@@ -475,9 +711,8 @@ ISet * ISet::intersect(
     return intersection;
 }
 
-ISet * ISet::sub(
-        ISet const * pOperand1, ISet const * pOperand2, IVector::NORM norm, double tolerance, ILogger * pLogger
-        ) {
+template <typename Norm>
+ISet * subSets(ISet const * pOperand1, ISet const * pOperand2, Norm norm, double tolerance, ILogger * pLogger) {
     char const * during = "ISet::sub";
 
     if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger) || !equalDims(pOperand1, pOperand2, during, pLogger)) {
@@ -496,6 +731,10 @@ ISet * ISet::sub(
         return nullptr;
     }
 
+    if(checkNorm(norm, pOperand1->getDim(), during, pLogger) != RESULT_CODE::SUCCESS) {
+        return nullptr;
+    }
+
     ISet * diff = ISet::createSet(pLogger);
 
     if(diff == nullptr) {
@@ -526,9 +765,8 @@ ISet * ISet::sub(
     return diff;
 }
 
-ISet * ISet::symSub(
-        ISet const * pOperand1, ISet const * pOperand2, IVector::NORM norm, double tolerance, ILogger * pLogger
-        ) {
+template <typename Norm>
+ISet * symSubSets(ISet const * pOperand1, ISet const * pOperand2, Norm norm, double tolerance, ILogger * pLogger) {
     char const * during = "ISet::symSub";
 
     if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger) || !equalDims(pOperand1, pOperand2, during, pLogger)) {
@@ -547,6 +785,10 @@ ISet * ISet::symSub(
         return nullptr;
     }
 
+    if(checkNorm(norm, pOperand1->getDim(), during, pLogger) != RESULT_CODE::SUCCESS) {
+        return nullptr;
+    }
+
     ISet * sum = ISet::add(pOperand1, pOperand2, norm, tolerance, pLogger);
     ISet * intersection = ISet::intersect(pOperand1, pOperand2, norm, tolerance, pLogger);
     ISet * symsub = ISet::sub(sum, intersection, norm, tolerance, pLogger);
@@ -559,3 +801,56 @@ ISet * ISet::symSub(
 
     return symsub;
 }
+}
+
+
+
+/* ISet operations */
+
+ISet * ISet::add(
+        ISet const * pOperand1, ISet const * pOperand2, IVector::NORM norm, double tolerance, ILogger * pLogger
+        ) {
+    return addSets(pOperand1, pOperand2, norm, tolerance, pLogger);
+}
+
+ISet * ISet::add(
+        ISet const * pOperand1, ISet const * pOperand2, INorm const * pNorm, double tolerance, ILogger * pLogger
+        ) {
+    return addSets(pOperand1, pOperand2, pNorm, tolerance, pLogger);
+}
+
+ISet * ISet::intersect(
+        ISet const * pOperand1, ISet const * pOperand2, IVector::NORM norm, double tolerance, ILogger * pLogger
+        ) {
+    return intersectSets(pOperand1, pOperand2, norm, tolerance, pLogger);
+}
+
+ISet * ISet::intersect(
+        ISet const * pOperand1, ISet const * pOperand2, INorm const * pNorm, double tolerance, ILogger * pLogger
+        ) {
+    return intersectSets(pOperand1, pOperand2, pNorm, tolerance, pLogger);
+}
+
+ISet * ISet::sub(
+        ISet const * pOperand1, ISet const * pOperand2, IVector::NORM norm, double tolerance, ILogger * pLogger
+        ) {
+    return subSets(pOperand1, pOperand2, norm, tolerance, pLogger);
+}
+
+ISet * ISet::sub(
+        ISet const * pOperand1, ISet const * pOperand2, INorm const * pNorm, double tolerance, ILogger * pLogger
+        ) {
+    return subSets(pOperand1, pOperand2, pNorm, tolerance, pLogger);
+}
+
+ISet * ISet::symSub(
+        ISet const * pOperand1, ISet const * pOperand2, IVector::NORM norm, double tolerance, ILogger * pLogger
+        ) {
+    return symSubSets(pOperand1, pOperand2, norm, tolerance, pLogger);
+}
+
+ISet * ISet::symSub(
+        ISet const * pOperand1, ISet const * pOperand2, INorm const * pNorm, double tolerance, ILogger * pLogger
+        ) {
+    return symSubSets(pOperand1, pOperand2, pNorm, tolerance, pLogger);
+}
@@ -0,0 +1,32 @@
+#ifndef INORM_H
+#define INORM_H
+
+#include<stddef.h>
+#include "IVector.h"
+
+/* norm of a vector with coordinates x_i: (sum of |w_i x_i|^p)^(1/p), or the maximum of |w_i x_i| for infinite p;
+   the weights scale the axes as scaling copies of the vectors would, without the copies */
+class INorm {
+public:
+    //p >= 1, std::numeric_limits<double>::infinity() for the maximum norm
+    static INorm* createNorm(double p, ILogger* pLogger);
+    //dim non-negative finite weights, the norm is then taken of vectors of dimension dim only
+    static INorm* createWeightedNorm(double p, size_t dim, double const* pWeights, ILogger* pLogger);
+    virtual ~INorm() = 0;
+    virtual INorm* clone() const = 0;
+
+    virtual double getP() const = 0;
+    //0 for unweighted norms, which accept any dimension
+    virtual size_t getDim() const = 0;
+    //nullptr for unweighted norms
+    virtual double const* getWeights() const = 0;
+    //NaN on error
+    virtual double norm(IVector const* pVector) const = 0;
+protected:
+    INorm() = default;
+private:
+    INorm(INorm const& norm) = delete;
+    INorm& operator=(INorm const& norm) = delete;
+};
+
+#endif // INORM_H
@@ -2,6 +2,10 @@
 #define ISET_H
 #include "ILogger.h"
 #include "IVector.h"
+
+class IMatrix;
+class INorm;
+
 class ISet {
 public:
 	static ISet* createSet(ILogger* pLogger);
@@ -14,11 +18,22 @@ public:
 	virtual void clear() = 0; // delete all
 	virtual RESULT_CODE erase(size_t index) = 0;
 	virtual RESULT_CODE erase(IVector const* pSample, IVector::NORM norm, double tolerance) = 0;
+	//the same with weighted and general Lp norms, standard ones among them are pruned by the cached vector norms
+	virtual RESULT_CODE insert(const IVector* pVector, INorm const* pNorm, double tolerance) = 0;
+	virtual RESULT_CODE get(IVector*& pVector, IVector const* pSample, INorm const* pNorm, double tolerance)const = 0;
+	virtual RESULT_CODE erase(IVector const* pSample, INorm const* pNorm, double tolerance) = 0;
 	virtual ISet* clone()const = 0;
+	//every vector is replaced by its image under a square matrix; MULTIPLE_DEFINITION if two images are within tolerance,
+	//like insert, and that or any other error leaves the set unchanged
+	virtual RESULT_CODE transform(IMatrix const* pMatrix, IVector::NORM norm, double tolerance) = 0;
 	static ISet* add(ISet const* pOperand1, ISet const* pOperand2, IVector::NORM norm, double tolerance, ILogger* pLogger);
 	static ISet* intersect(ISet const* pOperand1, ISet const* pOperand2, IVector::NORM norm, double tolerance, ILogger* pLogger);
         static ISet* sub(ISet const* pOperand1, ISet const* pOperand2, IVector::NORM norm, double tolerance, ILogger* pLogger);
 	static ISet* symSub(ISet const* pOperand1, ISet const* pOperand2, IVector::NORM norm, double tolerance, ILogger* pLogger);
+	static ISet* add(ISet const* pOperand1, ISet const* pOperand2, INorm const* pNorm, double tolerance, ILogger* pLogger);
+	static ISet* intersect(ISet const* pOperand1, ISet const* pOperand2, INorm const* pNorm, double tolerance, ILogger* pLogger);
+	static ISet* sub(ISet const* pOperand1, ISet const* pOperand2, INorm const* pNorm, double tolerance, ILogger* pLogger);
+	static ISet* symSub(ISet const* pOperand1, ISet const* pOperand2, INorm const* pNorm, double tolerance, ILogger* pLogger);
 protected:
 	ISet() = default;
 private:
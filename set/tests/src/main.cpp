@@ -2,6 +2,8 @@
 #include <limits>
 
 #include "../include/ISet.h"
+#include "../include/IMatrix.h"
+#include "../include/INorm.h"
 
 using namespace std;
 
@@ -795,6 +797,173 @@ bool testSymSubNegative() {
     return result;
 }
 
+bool testGetPruned() {
+    ISet * set = ISet::createSet(logger);
+    IVector::NORM const norms [] = {IVector::NORM::NORM_1, IVector::NORM::NORM_2, IVector::NORM::NORM_INF};
+    double sampleCoords [] = {0., 5.5, 0.};
+    IVector * sample = IVector::createVector(3, sampleCoords, logger);
+    bool result = true;
+
+    for(size_t i = 0; i < 10; ++i) {
+        double coords [] = {0., (double) i, 0.};
+        IVector * vector = IVector::createVector(3, coords, logger);
+
+        result &= set->insert(vector, NORM, TOLERANCE) == RESULT_CODE::SUCCESS;
+
+        delete vector;
+        vector = nullptr;
+    }
+
+    //vectors with far norms are skipped, the ones exactly at tolerance are not
+    for(IVector::NORM norm : norms) {
+        IVector * found = nullptr;
+
+        result &= set->get(found, sample, norm, 0.5) == RESULT_CODE::SUCCESS && found != nullptr &&
+                found->getCoord(1) == 5.;
+
+        delete found;
+        found = nullptr;
+
+        result &= set->get(found, sample, norm, 0.4) == RESULT_CODE::NOT_FOUND;
+    }
+
+    delete set;
+    delete sample;
+
+    set = nullptr;
+    sample = nullptr;
+
+    return result;
+}
+
+bool testTransform() {
+    ISet * set = ISet::createSet(logger);
+    double scale [] = {2., 0., 0., 0., 2., 0., 0., 0., 2.};
+    double shift [] = {1., 0., 0.};
+    IMatrix * matrix = IMatrix::createMatrix(3, 3, scale, shift, logger);
+    IMatrix * wrongMatrix = IMatrix::createIdentity(2, logger);
+    double movedCoords [] = {1., 10., 0.};
+    double oldCoords [] = {0., 5., 0.};
+    IVector * moved = IVector::createVector(3, movedCoords, logger);
+    IVector * old = IVector::createVector(3, oldCoords, logger);
+    bool result = true;
+
+    for(size_t i = 0; i < 10; ++i) {
+        double coords [] = {0., (double) i, 0.};
+        IVector * vector = IVector::createVector(3, coords, logger);
+
+        result &= set->insert(vector, NORM, TOLERANCE) == RESULT_CODE::SUCCESS;
+
+        delete vector;
+        vector = nullptr;
+    }
+
+    //the second coordinate is dropped, so every image is the same
+    double flat [] = {1., 0., 0., 0., 0., 0., 0., 0., 1.};
+    IMatrix * projection = IMatrix::createMatrix(3, 3, flat, nullptr, logger);
+    IVector * last = nullptr;
+
+    result &= set->transform(wrongMatrix, NORM, TOLERANCE) == RESULT_CODE::WRONG_DIM &&
+            set->transform(projection, NORM, TOLERANCE) == RESULT_CODE::MULTIPLE_DEFINITION &&
+            set->get(last, 9) == RESULT_CODE::SUCCESS && last != nullptr && last->getCoord(1) == 9. &&
+            set->transform(matrix, NORM, TOLERANCE) == RESULT_CODE::SUCCESS && set->getSize() == 10;
+
+    //norms cached before the transform must not prune the moved vectors
+    IVector * found = nullptr;
+
+    result &= set->get(found, moved, NORM, 0.5) == RESULT_CODE::SUCCESS && found != nullptr &&
+            found->getCoord(0) == 1. && found->getCoord(1) == 10.;
+    result &= set->get(found, old, NORM, 0.5) == RESULT_CODE::NOT_FOUND;
+
+    delete found;
+    delete last;
+    delete projection;
+    delete set;
+    delete matrix;
+    delete wrongMatrix;
+    delete moved;
+    delete old;
+
+    found = nullptr;
+    last = nullptr;
+    projection = nullptr;
+    set = nullptr;
+    matrix = nullptr;
+    wrongMatrix = nullptr;
+    moved = nullptr;
+    old = nullptr;
+
+    return result;
+}
+
+bool testWeightedNorm() {
+    ISet * set = ISet::createSet(logger);
+    ISet * other = ISet::createSet(logger);
+    //the second axis counts ten times less
+    double weights [] = {1., 0.1, 1.};
+    INorm * weighted = INorm::createWeightedNorm(2., 3, weights, logger);
+    INorm * euclidean = INorm::createNorm(2., logger);
+    INorm * wrongDim = INorm::createWeightedNorm(2., 2, weights, logger);
+    double sampleCoords [] = {0., 5.4, 0.};
+    IVector * sample = IVector::createVector(3, sampleCoords, logger);
+    IVector * found = nullptr;
+    bool result = true;
+
+    for(size_t i = 0; i < 10; ++i) {
+        double coords [] = {0., (double) i, 0.};
+        IVector * vector = IVector::createVector(3, coords, logger);
+
+        result &= set->insert(vector, NORM, TOLERANCE) == RESULT_CODE::SUCCESS;
+
+        delete vector;
+        vector = nullptr;
+    }
+
+    result &= set->insert(sample, weighted, 0.05) == RESULT_CODE::MULTIPLE_DEFINITION &&
+            set->insert(sample, wrongDim, 1.) == RESULT_CODE::WRONG_DIM &&
+            set->get(found, sample, static_cast <INorm const *> (nullptr), 1.) == RESULT_CODE::BAD_REFERENCE;
+
+    result &= set->get(found, sample, weighted, 0.05) == RESULT_CODE::SUCCESS && found != nullptr &&
+            found->getCoord(1) == 5.;
+
+    delete found;
+    found = nullptr;
+
+    //unweighted Euclidean norm is pruned by the cached norms and finds the same vector
+    result &= set->get(found, sample, euclidean, 0.5) == RESULT_CODE::SUCCESS && found != nullptr &&
+            found->getCoord(1) == 5. && set->get(found, sample, euclidean, 0.3) == RESULT_CODE::NOT_FOUND;
+
+    result &= other->insert(sample, NORM, TOLERANCE) == RESULT_CODE::SUCCESS;
+
+    ISet * intersection = ISet::intersect(set, other, weighted, 0.05, logger);
+    ISet * difference = ISet::sub(set, other, weighted, 0.05, logger);
+
+    result &= intersection != nullptr && intersection->getSize() == 1 && difference != nullptr &&
+            difference->getSize() == 9 && set->erase(sample, weighted, 0.05) == RESULT_CODE::SUCCESS &&
+            set->getSize() == 9;
+
+    delete found;
+    delete set;
+    delete other;
+    delete weighted;
+    delete euclidean;
+    delete wrongDim;
+    delete sample;
+    delete intersection;
+    delete difference;
+
+    found = nullptr;
+    set = nullptr;
+    other = nullptr;
+    weighted = nullptr;
+    euclidean = nullptr;
+    wrongDim = nullptr;
+    sample = nullptr;
+    intersection = nullptr;
+    difference = nullptr;
+
+    return result;
+}
 
 
 
@@ -848,6 +1017,9 @@ int main() {
     test("testSymSubWrongDim", testSymSubWrongDim);
     test("testSymSubNaN", testSymSubNaN);
     test("testSymSubNegative", testSymSubNegative);
+    test("testGetPruned", testGetPruned);
+    test("testTransform", testTransform);
+    test("testWeightedNorm", testWeightedNorm);
 
     if(passed) {
         cout << "\nAll tests PASSED\n";
@@ -18,6 +18,9 @@ DISTFILES += \
 
 HEADERS += \
     include/ILogger.h \
+    include/IMatrix.h \
+    include/INorm.h \
     include/ISet.h \
     include/IVector.h \
+    include/IVectorBatch.h \
     include/RC.h
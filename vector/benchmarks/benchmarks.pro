@@ -0,0 +1,38 @@
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+DEFINES += NDEBUG
+
+# the library is built in rather than linked, so that the counting operator new also sees its allocations
+SOURCES += \
+        ../src/DistanceMatrix.cpp \
+        ../src/Kernels.cpp \
+        ../src/Loggable.cpp \
+        ../src/Matrix.cpp \
+        ../src/Norm.cpp \
+        ../src/QuantizedBatch.cpp \
+        ../src/SparseVector.cpp \
+        ../src/Vector.cpp \
+        ../src/VectorArena.cpp \
+        ../src/VectorBatch.cpp \
+        ../src/VectorDataset.cpp \
+        ../src/VectorPool.cpp \
+        ../src/WorkerPool.cpp \
+        src/main.cpp
+
+LIBS += \
+    -L$$PWD/../libs/ -llogger
+
+DISTFILES += \
+    ../libs/logger.dll
+
+HEADERS += \
+    ../include/ILogger.h \
+    ../include/IVector.h \
+    ../include/RC.h \
+    ../src/Kernels.h \
+    ../src/Loggable.h \
+    ../src/SparseVector.h \
+    ../src/WorkerPool.h
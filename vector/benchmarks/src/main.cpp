@@ -0,0 +1,320 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <vector>
+
+#include "../../include/IVector.h"
+
+using namespace std;
+
+
+
+/* Allocation counting */
+
+atomic <size_t> allocations(0);
+atomic <size_t> allocatedBytes(0);
+
+void * countedAllocation(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+
+    return malloc(size == 0 ? 1 : size);
+}
+
+void * operator new(size_t size) {
+    void * block = countedAllocation(size);
+
+    if(block == nullptr) {
+        throw bad_alloc();
+    }
+
+    return block;
+}
+
+void * operator new[](size_t size) {
+    return operator new(size);
+}
+
+void * operator new(size_t size, nothrow_t const &) noexcept {
+    return countedAllocation(size);
+}
+
+void * operator new[](size_t size, nothrow_t const &) noexcept {
+    return countedAllocation(size);
+}
+
+void operator delete(void * block) noexcept {
+    free(block);
+}
+
+void operator delete[](void * block) noexcept {
+    free(block);
+}
+
+void operator delete(void * block, size_t) noexcept {
+    free(block);
+}
+
+void operator delete[](void * block, size_t) noexcept {
+    free(block);
+}
+
+
+
+/* Global vars */
+
+ILogger * logger = ILogger::createLogger(nullptr);
+//kept so that the compiler cannot drop the measured calls
+double volatile sink = 0.;
+double minSeconds = 0.05;
+bool firstResult = true;
+
+size_t const DIMS [] = {2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768, 65536};
+//every SPARSE_STEP-th coordinate of a sparse operand is non-zero
+size_t const SPARSE_STEP = 16;
+
+enum class LAYOUT {
+    DOUBLE,
+    FLOAT,
+    VIEW,
+    SPARSE
+};
+
+/* raw coordinates of one operand in every layout */
+struct Source {
+    vector <double> coords;
+    vector <float> floatCoords;
+    vector <double> values;
+};
+
+struct Operands {
+    LAYOUT layout;
+    size_t dim;
+    Source source1, source2;
+    vector <size_t> indices;
+    IVector * x;
+    IVector * y;
+};
+
+char const * layoutName(LAYOUT layout) {
+    switch(layout) {
+    case LAYOUT::DOUBLE:
+        return "double";
+    case LAYOUT::FLOAT:
+        return "float";
+    case LAYOUT::VIEW:
+        return "view";
+    case LAYOUT::SPARSE:
+        return "sparse";
+    }
+
+    return "";
+}
+
+char const * normName(IVector::NORM norm) {
+    switch(norm) {
+    case IVector::NORM::NORM_1:
+        return "NORM_1";
+    case IVector::NORM::NORM_2:
+        return "NORM_2";
+    case IVector::NORM::NORM_INF:
+        return "NORM_INF";
+    }
+
+    return "";
+}
+
+
+
+/* Measurement */
+
+/* runs op until minSeconds pass and prints one JSON object, norm may be nullptr */
+template <typename Operation>
+void measure(char const * name, Operands const & operands, char const * norm, Operation op) {
+    op();
+
+    size_t iterations = 1;
+    double seconds = 0.;
+    size_t count = 0, bytes = 0;
+
+    while(true) {
+        size_t allocationsBefore = allocations.load(), bytesBefore = allocatedBytes.load();
+        auto start = chrono::steady_clock::now();
+
+        for(size_t i = 0; i < iterations; ++i) {
+            op();
+        }
+
+        seconds = chrono::duration <double> (chrono::steady_clock::now() - start).count();
+        count = allocations.load() - allocationsBefore;
+        bytes = allocatedBytes.load() - bytesBefore;
+
+        if(seconds >= minSeconds || iterations >= ((size_t) 1 << 30)) {
+            break;
+        }
+
+        //aim a bit past minSeconds, at most 10 times more iterations per round
+        double scale = seconds > 0. ? 1.2 * minSeconds / seconds : 10.;
+
+        iterations = (size_t) (iterations * (scale < 10. ? (scale > 1.5 ? scale : 1.5) : 10.));
+    }
+
+    printf("%s\n    {\"operation\": \"%s\", \"layout\": \"%s\", \"dim\": %zu, \"norm\": %s%s%s, \"iterations\": %zu, "
+           "\"ns_per_op\": %.3f, \"bytes_per_op\": %.3f, \"allocations_per_op\": %.3f}",
+           firstResult ? "" : ",", name, layoutName(operands.layout), operands.dim, norm == nullptr ? "" : "\"",
+           norm == nullptr ? "null" : norm, norm == nullptr ? "" : "\"", iterations, seconds * 1e9 / iterations,
+           (double) bytes / iterations, (double) count / iterations);
+
+    firstResult = false;
+}
+
+IVector * createOperand(Operands & operands, Source & source) {
+    switch(operands.layout) {
+    case LAYOUT::DOUBLE:
+        return IVector::createVector(operands.dim, source.coords.data(), logger);
+    case LAYOUT::FLOAT:
+        return IVector::createFloatVector(operands.dim, source.floatCoords.data(), logger);
+    case LAYOUT::VIEW:
+        return IVector::createView(operands.dim, source.coords.data(), logger);
+    case LAYOUT::SPARSE:
+        return IVector::createSparseVector(operands.dim, operands.indices.size(), operands.indices.data(),
+                                           source.values.data(), logger);
+    }
+
+    return nullptr;
+}
+
+void fill(Source & source, size_t dim, double shift, vector <size_t> const & indices) {
+    source.coords.resize(dim);
+
+    for(size_t i = 0; i < dim; ++i) {
+        source.coords[i] = sin(i + shift) + 1.5;
+    }
+
+    source.floatCoords.assign(source.coords.begin(), source.coords.end());
+    source.values.clear();
+
+    for(size_t index : indices) {
+        source.values.push_back(source.coords[index]);
+    }
+}
+
+bool prepare(Operands & operands, LAYOUT layout, size_t dim) {
+    operands.layout = layout;
+    operands.dim = dim;
+
+    for(size_t i = 0; i < dim; i += SPARSE_STEP) {
+        operands.indices.push_back(i);
+    }
+
+    fill(operands.source1, dim, 0., operands.indices);
+    fill(operands.source2, dim, 1., operands.indices);
+
+    operands.x = createOperand(operands, operands.source1);
+    operands.y = createOperand(operands, operands.source2);
+
+    return operands.x != nullptr && operands.y != nullptr;
+}
+
+void runOperations(Operands & operands) {
+    IVector * x = operands.x;
+    IVector * y = operands.y;
+
+    //creation from raw coordinates, the layout decides the factory
+    measure("createVector", operands, nullptr, [&]() {
+        IVector * vec = createOperand(operands, operands.source1);
+
+        sink = sink + vec->getDim();
+        delete vec;
+    });
+
+    measure("clone", operands, nullptr, [&]() {
+        IVector * vec = x->clone();
+
+        sink = sink + vec->getDim();
+        delete vec;
+    });
+
+    measure("add", operands, nullptr, [&]() {
+        IVector * vec = IVector::add(x, y, logger);
+
+        sink = sink + vec->getDim();
+        delete vec;
+    });
+
+    measure("sub", operands, nullptr, [&]() {
+        IVector * vec = IVector::sub(x, y, logger);
+
+        sink = sink + vec->getDim();
+        delete vec;
+    });
+
+    measure("mulScalar", operands, nullptr, [&]() {
+        IVector * vec = IVector::mul(x, 0.5, logger);
+
+        sink = sink + vec->getDim();
+        delete vec;
+    });
+
+    measure("mulDot", operands, nullptr, [&]() {
+        sink = sink + IVector::mul(x, y, logger);
+    });
+
+    IVector::NORM const norms [] = {IVector::NORM::NORM_1, IVector::NORM::NORM_2, IVector::NORM::NORM_INF};
+
+    for(IVector::NORM norm : norms) {
+        measure("norm", operands, normName(norm), [&]() {
+            sink = sink + x->norm(norm);
+        });
+
+        //operands far apart, so the whole vector has to be read
+        measure("equals", operands, normName(norm), [&]() {
+            bool result = false;
+
+            IVector::equals(x, y, norm, 1e300, &result, logger);
+            sink = sink + result;
+        });
+    }
+}
+
+
+
+int main(int argc, char ** argv) {
+    //optional minimal time of one measurement, in milliseconds
+    if(argc > 1) {
+        minSeconds = atof(argv[1]) / 1000.;
+    }
+
+    LAYOUT const layouts [] = {LAYOUT::DOUBLE, LAYOUT::FLOAT, LAYOUT::VIEW, LAYOUT::SPARSE};
+
+    printf("{\n  \"benchmarks\": [");
+
+    for(LAYOUT layout : layouts) {
+        for(size_t dim : DIMS) {
+            Operands operands;
+
+            if(!prepare(operands, layout, dim)) {
+                fprintf(stderr, "Failed to create %s operands of dimension %zu\n", layoutName(layout), dim);
+
+                return 1;
+            }
+
+            runOperations(operands);
+
+            delete operands.x;
+            delete operands.y;
+
+            operands.x = nullptr;
+            operands.y = nullptr;
+        }
+    }
+
+    printf("\n  ]\n}\n");
+
+    logger->destroyLogger(nullptr);
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+#ifndef IQUANTIZEDBATCH_H
+#define IQUANTIZEDBATCH_H
+
+#include<stddef.h>
+#include "IVector.h"
+
+/* count vectors of one dimension stored as 8 or 16 bit integer codes, 8 or 4 times smaller than double coordinates:
+   coordinate j of vector i decodes to getOffset(i) + getScale(i) * code, the codes are stored vector by vector;
+   meant for scanning large collections, with the exact vectors kept apart to check the few candidates found */
+class IQuantizedBatch {
+public:
+    enum class CODE {
+        INT8,
+        INT16
+    };
+
+    //zero vectors
+    static IQuantizedBatch* createBatch(size_t count, size_t dim, CODE code, ILogger* pLogger);
+    virtual ~IQuantizedBatch() = 0;
+    virtual IQuantizedBatch* clone() const = 0;
+
+    virtual size_t getCount() const = 0;
+    virtual size_t getDim() const = 0;
+    virtual CODE getCode() const = 0;
+    //decoded coordinate, NaN on error
+    virtual double getCoord(size_t index, size_t coord) const = 0;
+    virtual double getScale(size_t index) const = 0;
+    virtual double getOffset(size_t index) const = 0;
+    //getCount() * getDim() codes of int8_t or int16_t as getCode() tells
+    virtual void const* getCodes() const = 0;
+    //the coordinates are rounded to the nearest code between the minimum and the maximum of them
+    virtual RESULT_CODE setVector(size_t index, IVector const* pVector) = 0;
+    //decoded copy
+    virtual IVector* createVector(size_t index) const = 0;
+    //norm of the difference between the vector that was set and the decoded one, NaN on error
+    virtual double getError(size_t index, IVector::NORM norm) const = 0;
+
+    /* asymmetric: the query stays exact and the codes are widened to doubles in registers, one result per vector */
+    static RESULT_CODE distance(IQuantizedBatch const* pBatch, IVector const* pQuery, IVector::NORM norm, double* pResults, ILogger* pLogger);
+    /* indices of the vectors that may lie within tolerance of pQuery in ascending order, pIndices holds getCount() entries;
+       no vector within tolerance by IVector::equals is left out, so the exact check is only needed for the candidates */
+    static RESULT_CODE filter(IQuantizedBatch const* pBatch, IVector const* pQuery, IVector::NORM norm, double tolerance,
+                              size_t* pIndices, size_t* pCount, ILogger* pLogger);
+protected:
+    IQuantizedBatch() = default;
+private:
+    IQuantizedBatch(IQuantizedBatch const& batch) = delete;
+    IQuantizedBatch& operator=(IQuantizedBatch const& batch) = delete;
+};
+
+#endif // IQUANTIZEDBATCH_H
@@ -0,0 +1,25 @@
+#ifndef IVECTORARENA_H
+#define IVECTORARENA_H
+
+#include<stddef.h>
+#include "ILogger.h"
+
+/* bump allocator for short-lived vectors, not thread safe: use one arena per worker */
+class IVectorArena {
+public:
+    static IVectorArena* createArena(size_t chunkSize, ILogger* pLogger);
+    virtual ~IVectorArena() = 0;
+
+    virtual void* allocate(size_t size, size_t alignment) = 0;
+    //releases everything at once, vectors created in the arena must not be used or deleted afterwards
+    virtual void reset() = 0;
+    virtual size_t getUsed() const = 0;
+    virtual size_t getCapacity() const = 0;
+protected:
+    IVectorArena() = default;
+private:
+    IVectorArena(IVectorArena const& arena) = delete;
+    IVectorArena& operator=(IVectorArena const& arena) = delete;
+};
+
+#endif // IVECTORARENA_H
@@ -0,0 +1,58 @@
+#ifndef IVECTORDATASET_H
+#define IVECTORDATASET_H
+
+#include<stddef.h>
+#include "IVector.h"
+#include "IVectorBatch.h"
+
+/* binary file of count vectors of one dimension in native byte order: a 64 byte header
+   (magic, scalar type, alignment, dim, count, data offset), then the rows one after another starting at a multiple of alignment */
+class IVectorDataset {
+public:
+    enum class SCALAR {
+        DOUBLE,
+        FLOAT
+    };
+
+    //maps the file without reading the rows, pages are loaded when they are touched
+    static IVectorDataset* open(char const* pPath, ILogger* pLogger);
+    virtual ~IVectorDataset() = 0;
+
+    virtual size_t getCount() const = 0;
+    virtual size_t getDim() const = 0;
+    virtual SCALAR getScalarType() const = 0;
+    /* read-only view over the mapped row for DOUBLE files, a float vector copy for FLOAT ones; views must not outlive the dataset;
+       the row is checked here rather than by open, nullptr (NAN_VALUE) if it has NaN */
+    virtual IVector* createVector(size_t index) const = 0;
+    //rows [first, first + count) copied into an interleaved batch, nullptr (NAN_VALUE) if one of them has NaN
+    virtual IVectorBatch* createBatch(size_t first, size_t count) const = 0;
+    //mapped rows, double const* or float const* depending on the scalar type, not checked for NaN
+    virtual void const* getData() const = 0;
+protected:
+    IVectorDataset() = default;
+private:
+    IVectorDataset(IVectorDataset const& dataset) = delete;
+    IVectorDataset& operator=(IVectorDataset const& dataset) = delete;
+};
+
+/* appends rows to a new dataset file, the count in the header is written by close or by the destructor */
+class IVectorDatasetWriter {
+public:
+    //alignment is a power of two not less than 8
+    static IVectorDatasetWriter* create(char const* pPath, size_t dim, IVectorDataset::SCALAR type, size_t alignment, ILogger* pLogger);
+    virtual ~IVectorDatasetWriter() = 0;
+
+    //a failed write closes the writer with the rows before it, later calls and close return FILE_ERROR
+    virtual RESULT_CODE append(IVector const* pVector) = 0;
+    virtual RESULT_CODE append(double const* pData) = 0;
+    virtual size_t getCount() const = 0;
+    //appending is not possible afterwards
+    virtual RESULT_CODE close() = 0;
+protected:
+    IVectorDatasetWriter() = default;
+private:
+    IVectorDatasetWriter(IVectorDatasetWriter const& writer) = delete;
+    IVectorDatasetWriter& operator=(IVectorDatasetWriter const& writer) = delete;
+};
+
+#endif // IVECTORDATASET_H
@@ -0,0 +1,31 @@
+#ifndef IVECTORPOOL_H
+#define IVECTORPOOL_H
+
+#include<stddef.h>
+#include "IVector.h"
+
+/* interns vectors: all requests with equal coordinates get one shared read-only vector holding 0.0 for -0.0, so such
+   vectors are equal exactly when the pointers are; not thread safe, though the interned vectors may be read from any
+   thread */
+class IVectorPool {
+public:
+    static IVectorPool* createPool(ILogger* pLogger);
+    //deletes the interned vectors, clones of them keep their coordinates
+    virtual ~IVectorPool() = 0;
+
+    /* the interned vector with the coordinates of pVector, created on the first request; it belongs to the pool,
+       clones of it share coordinates longer than a cache line until they are written and copy shorter ones;
+       nullptr on error */
+    virtual IVector const* intern(IVector const* pVector) = 0;
+    virtual IVector const* intern(size_t dim, double const* pData) = 0;
+    virtual size_t getCount() const = 0;
+    //vectors interned before must not be used afterwards
+    virtual void clear() = 0;
+protected:
+    IVectorPool() = default;
+private:
+    IVectorPool(IVectorPool const& pool) = delete;
+    IVectorPool& operator=(IVectorPool const& pool) = delete;
+};
+
+#endif // IVECTORPOOL_H
@@ -0,0 +1,224 @@
+#ifndef VECTOREXPR_H
+#define VECTOREXPR_H
+
+#include <stddef.h>
+#include <cmath>
+
+#include "IVector.h"
+
+
+
+/* Lazy vector expressions: a + 2. * (b - c) builds a tree of small nodes held by value,
+   evaluate writes it into the result vector in one fused loop without temporaries.
+   Every coordinate reads only the same coordinate of the operands, so the result may alias them */
+template <typename Derived>
+struct VectorExpression {
+    Derived const & derived() const {
+        return static_cast <Derived const &> (*this);
+    }
+};
+
+/* Leaf over an IVector, the vector must outlive the expression */
+class VectorOperand : public VectorExpression <VectorOperand> {
+public:
+    explicit VectorOperand(IVector const * pVector) : vector(pVector),
+        data(pVector == nullptr ? nullptr : pVector->getData()) {}
+
+    bool isValid() const {
+        return vector != nullptr;
+    }
+
+    size_t getDim() const {
+        return vector->getDim();
+    }
+
+    //every leaf keeps its coordinates as one array of doubles
+    bool isContiguous() const {
+        return data != nullptr;
+    }
+
+    //for contiguous expressions only
+    double at(size_t index) const {
+        return data[index];
+    }
+
+    double getCoord(size_t index) const {
+        return vector->getCoord(index);
+    }
+
+    //true if the leaf is pVector or its coordinates overlap the dim doubles at pData
+    bool aliases(IVector const * pVector, double const * pData, size_t dim) const {
+        return vector == pVector || (data != nullptr && (size_t) data < (size_t) (pData + dim) &&
+                                     (size_t) pData < (size_t) (data + vector->getDim()));
+    }
+
+private:
+    IVector const * vector;
+    double const * data;
+};
+
+template <typename Left, typename Right, int SIGN>
+class VectorSum : public VectorExpression <VectorSum <Left, Right, SIGN>> {
+public:
+    VectorSum(Left const & left, Right const & right) : left(left), right(right) {}
+
+    bool isValid() const {
+        return left.isValid() && right.isValid() && left.getDim() == right.getDim();
+    }
+
+    size_t getDim() const {
+        return left.getDim();
+    }
+
+    bool isContiguous() const {
+        return left.isContiguous() && right.isContiguous();
+    }
+
+    double at(size_t index) const {
+        return left.at(index) + SIGN * right.at(index);
+    }
+
+    double getCoord(size_t index) const {
+        return left.getCoord(index) + SIGN * right.getCoord(index);
+    }
+
+    bool aliases(IVector const * pVector, double const * pData, size_t dim) const {
+        return left.aliases(pVector, pData, dim) || right.aliases(pVector, pData, dim);
+    }
+
+private:
+    Left left;
+    Right right;
+};
+
+template <typename Operand>
+class VectorScale : public VectorExpression <VectorScale <Operand>> {
+public:
+    VectorScale(Operand const & operand, double scaleParam) : operand(operand), scaleParam(scaleParam) {}
+
+    bool isValid() const {
+        return operand.isValid() && !std::isnan(scaleParam);
+    }
+
+    size_t getDim() const {
+        return operand.getDim();
+    }
+
+    bool isContiguous() const {
+        return operand.isContiguous();
+    }
+
+    double at(size_t index) const {
+        return scaleParam * operand.at(index);
+    }
+
+    double getCoord(size_t index) const {
+        return scaleParam * operand.getCoord(index);
+    }
+
+    bool aliases(IVector const * pVector, double const * pData, size_t dim) const {
+        return operand.aliases(pVector, pData, dim);
+    }
+
+private:
+    Operand operand;
+    double scaleParam;
+};
+
+
+
+inline VectorOperand vectorExpr(IVector const * pVector) {
+    return VectorOperand(pVector);
+}
+
+template <typename Left, typename Right>
+VectorSum <Left, Right, 1> operator + (VectorExpression <Left> const & left, VectorExpression <Right> const & right) {
+    return VectorSum <Left, Right, 1>(left.derived(), right.derived());
+}
+
+template <typename Left, typename Right>
+VectorSum <Left, Right, -1> operator - (VectorExpression <Left> const & left, VectorExpression <Right> const & right) {
+    return VectorSum <Left, Right, -1>(left.derived(), right.derived());
+}
+
+template <typename Operand>
+VectorScale <Operand> operator * (double scaleParam, VectorExpression <Operand> const & operand) {
+    return VectorScale <Operand>(operand.derived(), scaleParam);
+}
+
+template <typename Operand>
+VectorScale <Operand> operator * (VectorExpression <Operand> const & operand, double scaleParam) {
+    return VectorScale <Operand>(operand.derived(), scaleParam);
+}
+
+/* pResult = expression; WRONG_ARGUMENT for nullptr operands, mismatched dimensions or a NaN scale,
+   CALCULATION_ERROR if a NaN coordinate would be obtained or a coordinate could not be set.
+   A contiguous result that is none of the operands is written in one pass and set to zero if a NaN coordinate
+   appears; any other result is checked in a pass of its own first and left unchanged */
+template <typename Expression>
+RESULT_CODE evaluate(IVector * pResult, VectorExpression <Expression> const & expression, ILogger * pLogger) {
+    Expression const & expr = expression.derived();
+    char const * error = nullptr;
+    RESULT_CODE code = RESULT_CODE::SUCCESS;
+
+    if(pResult == nullptr) {
+        error = "Result vector turned out to be equal to nullptr during \"evaluate\"";
+        code = RESULT_CODE::BAD_REFERENCE;
+    } else if(!expr.isValid()) {
+        error = "Invalid operand, dimension or scale in the expression during \"evaluate\"";
+        code = RESULT_CODE::WRONG_ARGUMENT;
+    } else if(expr.getDim() != pResult->getDim()) {
+        error = "The dimension of the result vector is not equal to the expression one during \"evaluate\"";
+        code = RESULT_CODE::WRONG_DIM;
+    }
+
+    if(error == nullptr) {
+        size_t dim = expr.getDim();
+        bool contiguous = expr.isContiguous();
+        double const * resultData = pResult->getData();
+        //a result that is none of the operands is checked while it is written
+        bool direct = contiguous && resultData != nullptr && !expr.aliases(pResult, resultData, dim);
+        bool failed = false;
+
+        //any other one before writing, since it may be one of the operands
+        for(size_t i = 0; i < dim && !direct; ++i) {
+            failed |= std::isnan(contiguous ? expr.at(i) : expr.getCoord(i));
+        }
+
+        double * result = failed ? nullptr : pResult->getMutableData();
+
+        if(failed) {
+            error = "NaN coordinate would be obtained, the result vector is left unchanged during \"evaluate\"";
+        } else if(result != nullptr && contiguous) {
+            for(size_t i = 0; i < dim; ++i) {
+                result[i] = expr.at(i);
+                failed |= std::isnan(result[i]);
+            }
+
+            for(size_t i = 0; i < dim && failed; ++i) {
+                result[i] = 0.;
+            }
+
+            error = failed ? "NaN coordinate was obtained, the result vector is set to zero during \"evaluate\"" :
+                             nullptr;
+        } else {
+            for(size_t i = 0; i < dim && !failed; ++i) {
+                failed = pResult->setCoord(i, expr.getCoord(i)) != RESULT_CODE::SUCCESS;
+            }
+
+            error = failed ? "Failed to set a coordinate during \"evaluate\"" : nullptr;
+        }
+
+        if(error != nullptr) {
+            code = RESULT_CODE::CALCULATION_ERROR;
+        }
+    }
+
+    if(error != nullptr && pLogger != nullptr) {
+        pLogger->log(error, code);
+    }
+
+    return code;
+}
+
+#endif // VECTOREXPR_H
@@ -0,0 +1,331 @@
+#include <cmath>
+#include <algorithm>
+#include <new>
+#include <vector>
+#include <limits>
+
+#include "../include/IVectorBatch.h"
+#include "Kernels.h"
+#include "Loggable.h"
+#include "WorkerPool.h"
+
+
+
+namespace {
+/* Everything the workers share, read-only; each of them writes the distances of its own rows */
+struct MatrixJob {
+    size_t rowsCount;
+    size_t columnsCount;
+    size_t dim;
+    IVector::NORM norm;
+    //rows copied out of their batch one after another, so that each of them is a kernel query
+    double const * rows;
+    double const * columns;
+    //squared, NORM_2 only
+    double const * rowNorms;
+    double const * columnNorms;
+
+    //selectDistances only
+    double threshold;
+    bool below;
+};
+
+//rows computed against one tile of columns before moving to the next tile
+size_t const ROW_TILE = 64;
+//bytes of columns per tile, small enough to stay in the L2 cache while a row tile passes over it
+size_t const COLUMN_TILE_BYTES = 128 * 1024;
+//fewer multiply-adds than this are not worth splitting between threads
+size_t const PARALLEL_WORK = 1 << 20;
+
+
+/* Secondary functions */
+
+bool validArguments(IVectorBatch const * pRows, IVectorBatch const * pColumns, IVector::NORM norm, bool hasOutput,
+                    char const * during, ILogger * pLogger) {
+    if(pRows == nullptr || pColumns == nullptr || !hasOutput) {
+        Loggable::printLogDuring("Batch or output turned out to be equal to nullptr", during, RESULT_CODE::BAD_REFERENCE,
+                                 pLogger);
+
+        return false;
+    }
+
+    if(pRows->getDim() != pColumns->getDim()) {
+        Loggable::printLogDuring("The dimensions of the batches are not equal", during, RESULT_CODE::WRONG_DIM, pLogger);
+
+        return false;
+    }
+
+    if(norm != IVector::NORM::NORM_1 && norm != IVector::NORM::NORM_2 && norm != IVector::NORM::NORM_INF) {
+        Loggable::printLogDuring("Invalid value of norm", during, RESULT_CODE::WRONG_ARGUMENT, pLogger);
+
+        return false;
+    }
+
+    return true;
+}
+
+RESULT_CODE errorCode(IVectorBatch const * pRows, IVectorBatch const * pColumns, bool hasOutput) {
+    if(pRows == nullptr || pColumns == nullptr || !hasOutput) {
+        return RESULT_CODE::BAD_REFERENCE;
+    }
+
+    return pRows->getDim() != pColumns->getDim() ? RESULT_CODE::WRONG_DIM : RESULT_CODE::WRONG_ARGUMENT;
+}
+
+/* distances of one row to the columns blocks [firstBlock, lastBlock), written to out[column] */
+void rowTile(MatrixJob const & job, size_t row, size_t firstBlock, size_t lastBlock, double * out) {
+    size_t const LANES = IVectorBatch::LANES;
+    Kernels const & kernels = Kernels::get();
+    double const * query = job.rows + row * job.dim;
+    double lanes[LANES];
+
+    for(size_t block = firstBlock; block < lastBlock; ++block) {
+        double const * columns = job.columns + block * LANES * job.dim;
+        size_t first = block * LANES;
+        size_t count = std::min(LANES, job.columnsCount - first);
+
+        switch(job.norm) {
+        case IVector::NORM::NORM_1:
+            kernels.batchDistance1(columns, query, job.dim, lanes);
+            break;
+
+        case IVector::NORM::NORM_2:
+            kernels.batchDot(columns, query, job.dim, lanes);
+
+            for(size_t lane = 0; lane < count; ++lane) {
+                double squared = job.rowNorms[row] + job.columnNorms[first + lane] - 2. * lanes[lane];
+
+                lanes[lane] = std::sqrt(std::max(squared, 0.));
+            }
+            break;
+
+        case IVector::NORM::NORM_INF:
+            kernels.batchDistanceInf(columns, query, job.dim, lanes);
+            break;
+        }
+
+        std::copy(lanes, lanes + count, out + first);
+    }
+}
+
+/* rows [begin, end) tile by tile, row r is written to out + (r - begin) * columnsCount */
+void computeRows(MatrixJob const & job, size_t begin, size_t end, double * out) {
+    size_t const LANES = IVectorBatch::LANES;
+    size_t blocksCount = (job.columnsCount + LANES - 1) / LANES;
+    size_t tileBlocks = std::max((size_t) 1, COLUMN_TILE_BYTES / (LANES * job.dim * sizeof(double)));
+
+    for(size_t rowsBegin = begin; rowsBegin < end; rowsBegin += ROW_TILE) {
+        size_t rowsEnd = std::min(end, rowsBegin + ROW_TILE);
+
+        for(size_t firstBlock = 0; firstBlock < blocksCount; firstBlock += tileBlocks) {
+            size_t lastBlock = std::min(blocksCount, firstBlock + tileBlocks);
+
+            for(size_t row = rowsBegin; row < rowsEnd; ++row) {
+                rowTile(job, row, firstBlock, lastBlock, out + (row - begin) * job.columnsCount);
+            }
+        }
+    }
+}
+
+/* NORM_2 distances come from the norms and the dot product with an error of up to about (dim + 2) ulps of
+   |a|^2 + |b|^2, so such a distance may fall on either side of the threshold */
+bool nearThreshold(MatrixJob const & job, size_t row, size_t column, double distance) {
+    if(job.norm != IVector::NORM::NORM_2 || job.threshold < 0.) {
+        return false;
+    }
+
+    double band = (job.dim + 2) * std::numeric_limits <double>::epsilon() *
+            (job.rowNorms[row] + job.columnNorms[column]);
+
+    return std::fabs(distance * distance - job.threshold * job.threshold) <= band;
+}
+
+/* NORM_2 distance from the coordinates themselves, buffer holds dim coordinates of the column */
+double exactDistance(MatrixJob const & job, size_t row, size_t column, double * buffer) {
+    size_t const LANES = IVectorBatch::LANES;
+
+    for(size_t j = 0; j < job.dim; ++j) {
+        buffer[j] = job.columns[(column / LANES * job.dim + j) * LANES + column % LANES];
+    }
+
+    return std::sqrt(Kernels::get().distance2Squared(job.rows + row * job.dim, buffer, job.dim));
+}
+
+/* threads worth using for the job */
+size_t threadsCount(MatrixJob const & job) {
+    if(job.rowsCount * job.columnsCount * job.dim < PARALLEL_WORK) {
+        return 1;
+    }
+
+    return WorkerPool::get().getThreadsCount();
+}
+
+/* computeRows on the shared workers, a row tile per task; nothing is allocated by the tasks, so none of them throws */
+void runRows(MatrixJob const & job, size_t begin, size_t end, double * out) {
+    size_t tiles = (end - begin + ROW_TILE - 1) / ROW_TILE;
+
+    auto task = [&](size_t t) {
+        size_t first = begin + t * ROW_TILE;
+
+        computeRows(job, first, std::min(end, first + ROW_TILE), out + (first - begin) * job.columnsCount);
+    };
+
+    bool parallel = tiles > 1 && threadsCount(job) > 1;
+
+    try {
+        if(parallel) {
+            WorkerPool::get().run(tiles, task);
+        }
+    } catch(std::bad_alloc const &) {
+        //the tasks are run one after another below
+        parallel = false;
+    }
+
+    for(size_t t = 0; t < tiles && !parallel; ++t) {
+        task(t);
+    }
+}
+
+/* fills the job with the rows copy and the norms, then pass(job) computes the distances */
+template <typename Pass>
+RESULT_CODE distances(IVectorBatch const * pRows, IVectorBatch const * pColumns, MatrixJob & job, Pass const & pass,
+                      char const * during, ILogger * pLogger) {
+    size_t const LANES = IVectorBatch::LANES;
+    double const * rowsData = pRows->getData();
+
+    job.rowsCount = pRows->getCount();
+    job.columnsCount = pColumns->getCount();
+    job.dim = pRows->getDim();
+    job.columns = pColumns->getData();
+
+    std::vector <double> rows, rowNorms, columnNorms;
+
+    try {
+        rows.resize(job.rowsCount * job.dim);
+
+        if(job.norm == IVector::NORM::NORM_2) {
+            rowNorms.resize(job.rowsCount + LANES);
+            columnNorms.resize(job.columnsCount + LANES);
+        }
+    } catch(std::bad_alloc const &) {
+        return Loggable::printLogDuring("Not enough memory for the rows copy", during, RESULT_CODE::OUT_OF_MEMORY,
+                                        pLogger);
+    }
+
+    for(size_t row = 0; row < job.rowsCount; ++row) {
+        for(size_t j = 0; j < job.dim; ++j) {
+            rows[row * job.dim + j] = rowsData[(row / LANES * job.dim + j) * LANES + row % LANES];
+        }
+    }
+
+    if(job.norm == IVector::NORM::NORM_2) {
+        Kernels const & kernels = Kernels::get();
+
+        for(size_t first = 0; first < job.rowsCount; first += LANES) {
+            kernels.batchNorm2Squared(rowsData + first * job.dim, job.dim, rowNorms.data() + first);
+        }
+
+        for(size_t first = 0; first < job.columnsCount; first += LANES) {
+            kernels.batchNorm2Squared(job.columns + first * job.dim, job.dim, columnNorms.data() + first);
+        }
+    }
+
+    job.rows = rows.data();
+    job.rowNorms = rowNorms.data();
+    job.columnNorms = columnNorms.data();
+
+    return pass(job);
+}
+}
+
+
+
+/* IVectorBatch */
+
+RESULT_CODE IVectorBatch::distanceMatrix(IVectorBatch const * pRows, IVectorBatch const * pColumns, IVector::NORM norm,
+                                         double * pMatrix, ILogger * pLogger) {
+    char const * during = "IVectorBatch::distanceMatrix";
+
+    if(!validArguments(pRows, pColumns, norm, pMatrix != nullptr, during, pLogger)) {
+        return errorCode(pRows, pColumns, pMatrix != nullptr);
+    }
+
+    MatrixJob job = MatrixJob();
+
+    job.norm = norm;
+
+    return distances(pRows, pColumns, job, [&](MatrixJob const & filled) {
+        runRows(filled, 0, filled.rowsCount, pMatrix);
+
+        return RESULT_CODE::SUCCESS;
+    }, during, pLogger);
+}
+
+RESULT_CODE IVectorBatch::selectDistances(IVectorBatch const * pRows, IVectorBatch const * pColumns,
+                                          IVector::NORM norm, double threshold, bool below,
+                                          void (* pCallback)(size_t, size_t, double, void *), void * pContext,
+                                          ILogger * pLogger) {
+    char const * during = "IVectorBatch::selectDistances";
+
+    if(!validArguments(pRows, pColumns, norm, pCallback != nullptr, during, pLogger)) {
+        return errorCode(pRows, pColumns, pCallback != nullptr);
+    }
+
+    if(std::isnan(threshold)) {
+        return Loggable::printLogDuring("Threshold equal to NaN is passed", during, RESULT_CODE::NAN_VALUE, pLogger);
+    }
+
+    MatrixJob job = MatrixJob();
+
+    job.norm = norm;
+    job.threshold = threshold;
+    job.below = below;
+
+    //a row tile per thread is computed at a time, the pairs of every wave of tiles are passed on before the next one
+    return distances(pRows, pColumns, job, [&](MatrixJob const & filled) {
+        std::vector <double> scratch, column;
+        size_t waveRows = threadsCount(filled) * ROW_TILE;
+
+        try {
+            column.resize(filled.dim);
+        } catch(std::bad_alloc const &) {
+            return Loggable::printLogDuring("Not enough memory for a column copy", during, RESULT_CODE::OUT_OF_MEMORY,
+                                            pLogger);
+        }
+
+        while(scratch.empty()) {
+            try {
+                scratch.resize(std::min(waveRows, filled.rowsCount) * filled.columnsCount);
+            } catch(std::bad_alloc const &) {
+                if(waveRows == ROW_TILE) {
+                    return Loggable::printLogDuring("Not enough memory for the distances of a row tile", during,
+                                                    RESULT_CODE::OUT_OF_MEMORY, pLogger);
+                }
+
+                waveRows = ROW_TILE;
+            }
+        }
+
+        for(size_t begin = 0; begin < filled.rowsCount; begin += waveRows) {
+            size_t end = std::min(filled.rowsCount, begin + waveRows);
+
+            runRows(filled, begin, end, scratch.data());
+
+            for(size_t row = begin; row < end; ++row) {
+                for(size_t j = 0; j < filled.columnsCount; ++j) {
+                    double distance = scratch[(row - begin) * filled.columnsCount + j];
+
+                    if(nearThreshold(filled, row, j, distance)) {
+                        distance = exactDistance(filled, row, j, column.data());
+                    }
+
+                    if((distance <= filled.threshold) == filled.below) {
+                        pCallback(row, j, distance, pContext);
+                    }
+                }
+            }
+        }
+
+        return RESULT_CODE::SUCCESS;
+    }, during, pLogger);
+}
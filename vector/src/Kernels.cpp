@@ -0,0 +1,1166 @@
+#include <cmath>
+#include <algorithm>
+#include <string.h>
+
+#include "Kernels.h"
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define KERNELS_X86
+#include <immintrin.h>
+#endif
+
+
+
+namespace {
+/* Scalar reference */
+
+bool scalarSupported() {
+    return true;
+}
+
+template <typename T>
+double scalarNorm1(T const * x, size_t dim) {
+    double result = 0.;
+
+    for(size_t i = 0; i < dim; ++i) {
+        result += std::fabs((double) x[i]);
+    }
+
+    return result;
+}
+
+template <typename T>
+double scalarNorm2Squared(T const * x, size_t dim) {
+    double result = 0.;
+
+    for(size_t i = 0; i < dim; ++i) {
+        result += (double) x[i] * x[i];
+    }
+
+    return result;
+}
+
+template <typename T>
+double scalarNormInf(T const * x, size_t dim) {
+    double result = 0.;
+
+    for(size_t i = 0; i < dim; ++i) {
+        result = std::max(result, std::fabs((double) x[i]));
+    }
+
+    return result;
+}
+
+template <typename T>
+double scalarDot(T const * x, T const * y, size_t dim) {
+    double result = 0.;
+
+    for(size_t i = 0; i < dim; ++i) {
+        result += (double) x[i] * y[i];
+    }
+
+    return result;
+}
+
+template <typename T>
+double scalarDistance1(T const * x, T const * y, size_t dim) {
+    double result = 0.;
+
+    for(size_t i = 0; i < dim; ++i) {
+        result += std::fabs((double) x[i] - y[i]);
+    }
+
+    return result;
+}
+
+template <typename T>
+double scalarDistance2Squared(T const * x, T const * y, size_t dim) {
+    double result = 0.;
+
+    for(size_t i = 0; i < dim; ++i) {
+        double diff = (double) x[i] - y[i];
+        result += diff * diff;
+    }
+
+    return result;
+}
+
+template <typename T>
+double scalarDistanceInf(T const * x, T const * y, size_t dim) {
+    double result = 0.;
+
+    for(size_t i = 0; i < dim; ++i) {
+        result = std::max(result, std::fabs((double) x[i] - y[i]));
+    }
+
+    return result;
+}
+
+template <typename T>
+bool scalarHasNaN(T const * x, size_t dim) {
+    bool nanFound = false;
+
+    for(size_t i = 0; i < dim; ++i) {
+        nanFound |= x[i] != x[i];
+    }
+
+    return nanFound;
+}
+
+/* Batched kernels, one accumulator per vector of the block.
+   Query-less operations are norms, as distances to the zero vector */
+
+enum BatchOperation {
+    BATCH_DOT,
+    BATCH_DISTANCE_1,
+    BATCH_DISTANCE_2_SQUARED,
+    BATCH_DISTANCE_INF
+};
+
+//also instantiated for whole blocks of lanes, so only operators are used
+template <int OPERATION, typename T>
+inline __attribute__((always_inline)) void batchStep(T & accumulator, T const & x, T const & y) {
+    T diff = x - y;
+
+    switch(OPERATION) {
+    case BATCH_DOT:
+        accumulator += x * y;
+        break;
+
+    case BATCH_DISTANCE_1:
+        accumulator += diff < 0. ? -diff : diff;
+        break;
+
+    case BATCH_DISTANCE_2_SQUARED:
+        accumulator += diff * diff;
+        break;
+
+    default:
+        diff = diff < 0. ? -diff : diff;
+        accumulator = accumulator < diff ? diff : accumulator;
+        break;
+    }
+}
+
+template <int OPERATION, bool QUERY>
+void scalarBatch(double const * block, double const * query, size_t dim, double * result) {
+    for(size_t lane = 0; lane < Kernels::BATCH_LANES; ++lane) {
+        double accumulator = 0.;
+
+        for(size_t j = 0; j < dim; ++j) {
+            double y = QUERY ? query[j] : 0.;
+
+            batchStep <OPERATION> (accumulator, block[j * Kernels::BATCH_LANES + lane], y);
+        }
+
+        result[lane] = accumulator;
+    }
+}
+
+template <int OPERATION>
+void scalarBatchNorm(double const * block, size_t dim, double * result) {
+    scalarBatch <OPERATION, false> (block, nullptr, dim, result);
+}
+
+/* Weighted distances, steps of the batched kernels over scaled differences */
+
+template <int OPERATION>
+double scalarWeighted(double const * x, double const * y, double const * w, size_t dim) {
+    double accumulator = 0.;
+
+    for(size_t i = 0; i < dim; ++i) {
+        batchStep <OPERATION> (accumulator, (x[i] - y[i]) * w[i], 0.);
+    }
+
+    return accumulator;
+}
+
+/* Distances to quantized codes */
+
+template <int OPERATION, typename T>
+double scalarCode(double const * query, T const * codes, double scale, double offset, size_t dim) {
+    double accumulator = 0.;
+
+    for(size_t i = 0; i < dim; ++i) {
+        batchStep <OPERATION> (accumulator, query[i], offset + scale * codes[i]);
+    }
+
+    return accumulator;
+}
+
+#define SCALAR_CODE_KERNELS(T) \
+    scalarCode <BATCH_DISTANCE_1, T>, scalarCode <BATCH_DISTANCE_2_SQUARED, T>, scalarCode <BATCH_DISTANCE_INF, T>
+
+void scalarBatchTransform(double const * matrix, size_t rows, size_t cols, double const * block, double * result) {
+    for(size_t i = 0; i < rows; ++i) {
+        for(size_t lane = 0; lane < Kernels::BATCH_LANES; ++lane) {
+            double accumulator = 0.;
+
+            for(size_t j = 0; j < cols; ++j) {
+                accumulator += matrix[i * cols + j] * block[j * Kernels::BATCH_LANES + lane];
+            }
+
+            result[i * Kernels::BATCH_LANES + lane] = accumulator;
+        }
+    }
+}
+
+Kernels const SCALAR = {
+    "scalar", scalarSupported,
+    scalarNorm1 <double>, scalarNorm2Squared <double>, scalarNormInf <double>, scalarDot <double>,
+    scalarDistance1 <double>, scalarDistance2Squared <double>, scalarDistanceInf <double>,
+    scalarNorm1 <float>, scalarNorm2Squared <float>, scalarNormInf <float>, scalarDot <float>,
+    scalarDistance1 <float>, scalarDistance2Squared <float>, scalarDistanceInf <float>,
+    scalarWeighted <BATCH_DISTANCE_1>, scalarWeighted <BATCH_DISTANCE_2_SQUARED>, scalarWeighted <BATCH_DISTANCE_INF>,
+    SCALAR_CODE_KERNELS(int8_t), SCALAR_CODE_KERNELS(int16_t),
+    scalarHasNaN <double>, scalarHasNaN <float>,
+    scalarBatchNorm <BATCH_DISTANCE_1>, scalarBatchNorm <BATCH_DISTANCE_2_SQUARED>,
+    scalarBatchNorm <BATCH_DISTANCE_INF>,
+    scalarBatch <BATCH_DOT, true>, scalarBatch <BATCH_DISTANCE_1, true>, scalarBatch <BATCH_DISTANCE_2_SQUARED, true>,
+    scalarBatch <BATCH_DISTANCE_INF, true>,
+    scalarBatchTransform
+};
+
+
+
+#ifdef KERNELS_X86
+/* Batched kernels over whole blocks, lowered by the compiler to the registers of the calling backend */
+
+typedef double BatchLanes __attribute__((vector_size(Kernels::BATCH_LANES * sizeof(double))));
+
+template <int OPERATION, bool QUERY>
+inline __attribute__((always_inline)) void lanesBatch(double const * block, double const * query, size_t dim,
+                                                      double * result) {
+    BatchLanes accumulator = BatchLanes();
+
+    for(size_t j = 0; j < dim; ++j) {
+        BatchLanes x;
+        BatchLanes y = BatchLanes() + (QUERY ? query[j] : 0.);
+
+        memcpy(&x, block + j * Kernels::BATCH_LANES, sizeof(x));
+        batchStep <OPERATION> (accumulator, x, y);
+    }
+
+    memcpy(result, &accumulator, sizeof(accumulator));
+}
+
+//rows of the matrix per pass over the block, each loaded block row feeds this many accumulators
+size_t const TRANSFORM_ROWS = 4;
+
+inline __attribute__((always_inline)) void lanesBatchTransform(double const * matrix, size_t rows, size_t cols,
+                                                               double const * block, double * result) {
+    size_t i = 0;
+
+    for(; i + TRANSFORM_ROWS <= rows; i += TRANSFORM_ROWS) {
+        double const * row = matrix + i * cols;
+        BatchLanes accumulator0 = BatchLanes(), accumulator1 = BatchLanes();
+        BatchLanes accumulator2 = BatchLanes(), accumulator3 = BatchLanes();
+
+        for(size_t j = 0; j < cols; ++j) {
+            BatchLanes x;
+
+            memcpy(&x, block + j * Kernels::BATCH_LANES, sizeof(x));
+            accumulator0 += row[j] * x;
+            accumulator1 += row[cols + j] * x;
+            accumulator2 += row[2 * cols + j] * x;
+            accumulator3 += row[3 * cols + j] * x;
+        }
+
+        memcpy(result + i * Kernels::BATCH_LANES, &accumulator0, sizeof(accumulator0));
+        memcpy(result + (i + 1) * Kernels::BATCH_LANES, &accumulator1, sizeof(accumulator1));
+        memcpy(result + (i + 2) * Kernels::BATCH_LANES, &accumulator2, sizeof(accumulator2));
+        memcpy(result + (i + 3) * Kernels::BATCH_LANES, &accumulator3, sizeof(accumulator3));
+    }
+
+    for(; i < rows; ++i) {
+        BatchLanes accumulator = BatchLanes();
+
+        for(size_t j = 0; j < cols; ++j) {
+            BatchLanes x;
+
+            memcpy(&x, block + j * Kernels::BATCH_LANES, sizeof(x));
+            accumulator += matrix[i * cols + j] * x;
+        }
+
+        memcpy(result + i * Kernels::BATCH_LANES, &accumulator, sizeof(accumulator));
+    }
+}
+
+template <int OPERATION>
+inline __attribute__((always_inline)) double lanesWeighted(double const * x, double const * y, double const * w,
+                                                           size_t dim) {
+    size_t const LANES = Kernels::BATCH_LANES;
+    BatchLanes accumulator = BatchLanes();
+    size_t i = 0;
+
+    for(; i + LANES <= dim; i += LANES) {
+        BatchLanes x0, y0, w0;
+
+        memcpy(&x0, x + i, sizeof(x0));
+        memcpy(&y0, y + i, sizeof(y0));
+        memcpy(&w0, w + i, sizeof(w0));
+        batchStep <OPERATION> (accumulator, (x0 - y0) * w0, BatchLanes());
+    }
+
+    double lanes[LANES];
+    double result = scalarWeighted <OPERATION> (x + i, y + i, w + i, dim - i);
+
+    memcpy(lanes, &accumulator, sizeof(accumulator));
+
+    for(size_t lane = 0; lane < LANES; ++lane) {
+        result = OPERATION == BATCH_DISTANCE_INF ? std::max(result, lanes[lane]) : result + lanes[lane];
+    }
+
+    return result;
+}
+
+#define WEIGHTED_KERNELS(PREFIX, TARGET) \
+    TARGET double PREFIX##WeightedDistance1(double const * x, double const * y, double const * w, size_t dim) { \
+        return lanesWeighted <BATCH_DISTANCE_1> (x, y, w, dim); \
+    } \
+    TARGET double PREFIX##WeightedDistance2Squared(double const * x, double const * y, double const * w, size_t dim) { \
+        return lanesWeighted <BATCH_DISTANCE_2_SQUARED> (x, y, w, dim); \
+    } \
+    TARGET double PREFIX##WeightedDistanceInf(double const * x, double const * y, double const * w, size_t dim) { \
+        return lanesWeighted <BATCH_DISTANCE_INF> (x, y, w, dim); \
+    }
+
+/* Decode::load widens the next codes into one register of Decode::Lanes doubles */
+template <int OPERATION, typename Decode, typename T>
+inline __attribute__((always_inline)) double lanesCode(double const * query, T const * codes, double scale,
+                                                       double offset, size_t dim) {
+    typedef typename Decode::Lanes Lanes;
+    size_t const WIDTH = sizeof(Lanes) / sizeof(double);
+    Lanes scales = Lanes() + scale, offsets = Lanes() + offset;
+    Lanes accumulator0 = Lanes(), accumulator1 = Lanes();
+    size_t i = 0;
+
+    for(; i + 2 * WIDTH <= dim; i += 2 * WIDTH) {
+        Lanes x0, x1, code0, code1;
+
+        memcpy(&x0, query + i, sizeof(x0));
+        memcpy(&x1, query + i + WIDTH, sizeof(x1));
+        Decode::load(codes + i, code0);
+        Decode::load(codes + i + WIDTH, code1);
+        batchStep <OPERATION> (accumulator0, x0, offsets + scales * code0);
+        batchStep <OPERATION> (accumulator1, x1, offsets + scales * code1);
+    }
+
+    double lanes[2 * WIDTH];
+    double result = scalarCode <OPERATION> (query + i, codes + i, scale, offset, dim - i);
+
+    memcpy(lanes, &accumulator0, sizeof(accumulator0));
+    memcpy(lanes + WIDTH, &accumulator1, sizeof(accumulator1));
+
+    for(size_t lane = 0; lane < 2 * WIDTH; ++lane) {
+        result = OPERATION == BATCH_DISTANCE_INF ? std::max(result, lanes[lane]) : result + lanes[lane];
+    }
+
+    return result;
+}
+
+#define CODE_KERNEL(PREFIX, TARGET, DECODE, NAME, OPERATION, T) \
+    TARGET double PREFIX##CodeDistance##NAME(double const * query, T const * codes, double scale, double offset, \
+                                             size_t dim) { \
+        return lanesCode <OPERATION, DECODE> (query, codes, scale, offset, dim); \
+    }
+
+#define CODE_KERNELS(PREFIX, TARGET, DECODE) \
+    CODE_KERNEL(PREFIX, TARGET, DECODE, 1Int8, BATCH_DISTANCE_1, int8_t) \
+    CODE_KERNEL(PREFIX, TARGET, DECODE, 2SquaredInt8, BATCH_DISTANCE_2_SQUARED, int8_t) \
+    CODE_KERNEL(PREFIX, TARGET, DECODE, InfInt8, BATCH_DISTANCE_INF, int8_t) \
+    CODE_KERNEL(PREFIX, TARGET, DECODE, 1Int16, BATCH_DISTANCE_1, int16_t) \
+    CODE_KERNEL(PREFIX, TARGET, DECODE, 2SquaredInt16, BATCH_DISTANCE_2_SQUARED, int16_t) \
+    CODE_KERNEL(PREFIX, TARGET, DECODE, InfInt16, BATCH_DISTANCE_INF, int16_t)
+
+#define CODE_KERNELS_TABLE(PREFIX) \
+    PREFIX##CodeDistance1Int8, PREFIX##CodeDistance2SquaredInt8, PREFIX##CodeDistanceInfInt8, \
+    PREFIX##CodeDistance1Int16, PREFIX##CodeDistance2SquaredInt16, PREFIX##CodeDistanceInfInt16
+
+#define BATCH_KERNELS(PREFIX, TARGET) \
+    TARGET void PREFIX##BatchNorm1(double const * block, size_t dim, double * result) { \
+        lanesBatch <BATCH_DISTANCE_1, false> (block, nullptr, dim, result); \
+    } \
+    TARGET void PREFIX##BatchNorm2Squared(double const * block, size_t dim, double * result) { \
+        lanesBatch <BATCH_DISTANCE_2_SQUARED, false> (block, nullptr, dim, result); \
+    } \
+    TARGET void PREFIX##BatchNormInf(double const * block, size_t dim, double * result) { \
+        lanesBatch <BATCH_DISTANCE_INF, false> (block, nullptr, dim, result); \
+    } \
+    TARGET void PREFIX##BatchDot(double const * block, double const * query, size_t dim, double * result) { \
+        lanesBatch <BATCH_DOT, true> (block, query, dim, result); \
+    } \
+    TARGET void PREFIX##BatchDistance1(double const * block, double const * query, size_t dim, double * result) { \
+        lanesBatch <BATCH_DISTANCE_1, true> (block, query, dim, result); \
+    } \
+    TARGET void PREFIX##BatchDistance2Squared(double const * block, double const * query, size_t dim, \
+                                              double * result) { \
+        lanesBatch <BATCH_DISTANCE_2_SQUARED, true> (block, query, dim, result); \
+    } \
+    TARGET void PREFIX##BatchDistanceInf(double const * block, double const * query, size_t dim, double * result) { \
+        lanesBatch <BATCH_DISTANCE_INF, true> (block, query, dim, result); \
+    } \
+    TARGET void PREFIX##BatchTransform(double const * matrix, size_t rows, size_t cols, double const * block, \
+                                       double * result) { \
+        lanesBatchTransform(matrix, rows, cols, block, result); \
+    }
+
+
+
+/* SSE2 */
+
+#define SSE2 __attribute__((target("sse2")))
+
+SSE2 bool sse2Supported() {
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("sse2");
+}
+
+SSE2 inline __m128d sse2Abs(__m128d x) {
+    return _mm_andnot_pd(_mm_set1_pd(-0.), x);
+}
+
+SSE2 inline double sse2Sum(__m128d x) {
+    return _mm_cvtsd_f64(_mm_add_sd(x, _mm_unpackhi_pd(x, x)));
+}
+
+SSE2 inline double sse2Max(__m128d x) {
+    return _mm_cvtsd_f64(_mm_max_sd(x, _mm_unpackhi_pd(x, x)));
+}
+
+SSE2 double sse2Norm1(double const * x, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        acc0 = _mm_add_pd(acc0, sse2Abs(_mm_loadu_pd(x + i)));
+        acc1 = _mm_add_pd(acc1, sse2Abs(_mm_loadu_pd(x + i + 2)));
+    }
+
+    return sse2Sum(_mm_add_pd(acc0, acc1)) + scalarNorm1(x + i, dim - i);
+}
+
+SSE2 double sse2Norm2Squared(double const * x, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        __m128d x0 = _mm_loadu_pd(x + i), x1 = _mm_loadu_pd(x + i + 2);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(x0, x0));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(x1, x1));
+    }
+
+    return sse2Sum(_mm_add_pd(acc0, acc1)) + scalarNorm2Squared(x + i, dim - i);
+}
+
+SSE2 double sse2NormInf(double const * x, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        acc0 = _mm_max_pd(acc0, sse2Abs(_mm_loadu_pd(x + i)));
+        acc1 = _mm_max_pd(acc1, sse2Abs(_mm_loadu_pd(x + i + 2)));
+    }
+
+    return std::max(sse2Max(_mm_max_pd(acc0, acc1)), scalarNormInf(x + i, dim - i));
+}
+
+SSE2 double sse2Dot(double const * x, double const * y, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+    }
+
+    return sse2Sum(_mm_add_pd(acc0, acc1)) + scalarDot(x + i, y + i, dim - i);
+}
+
+SSE2 double sse2Distance1(double const * x, double const * y, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        acc0 = _mm_add_pd(acc0, sse2Abs(_mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i))));
+        acc1 = _mm_add_pd(acc1, sse2Abs(_mm_sub_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2))));
+    }
+
+    return sse2Sum(_mm_add_pd(acc0, acc1)) + scalarDistance1(x + i, y + i, dim - i);
+}
+
+SSE2 double sse2Distance2Squared(double const * x, double const * y, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        __m128d d0 = _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i));
+        __m128d d1 = _mm_sub_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2));
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(d0, d0));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(d1, d1));
+    }
+
+    return sse2Sum(_mm_add_pd(acc0, acc1)) + scalarDistance2Squared(x + i, y + i, dim - i);
+}
+
+SSE2 double sse2DistanceInf(double const * x, double const * y, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        acc0 = _mm_max_pd(acc0, sse2Abs(_mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i))));
+        acc1 = _mm_max_pd(acc1, sse2Abs(_mm_sub_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2))));
+    }
+
+    return std::max(sse2Max(_mm_max_pd(acc0, acc1)), scalarDistanceInf(x + i, y + i, dim - i));
+}
+
+/* four floats are widened to two pairs of doubles */
+#define SSE2_FLOAT_LOAD(low, high, pointer) \
+    __m128 packed##low = _mm_loadu_ps(pointer); \
+    __m128d low = _mm_cvtps_pd(packed##low); \
+    __m128d high = _mm_cvtps_pd(_mm_movehl_ps(packed##low, packed##low))
+
+SSE2 double sse2Norm1Float(float const * x, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        SSE2_FLOAT_LOAD(x0, x1, x + i);
+        acc0 = _mm_add_pd(acc0, sse2Abs(x0));
+        acc1 = _mm_add_pd(acc1, sse2Abs(x1));
+    }
+
+    return sse2Sum(_mm_add_pd(acc0, acc1)) + scalarNorm1(x + i, dim - i);
+}
+
+SSE2 double sse2Norm2SquaredFloat(float const * x, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        SSE2_FLOAT_LOAD(x0, x1, x + i);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(x0, x0));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(x1, x1));
+    }
+
+    return sse2Sum(_mm_add_pd(acc0, acc1)) + scalarNorm2Squared(x + i, dim - i);
+}
+
+SSE2 double sse2NormInfFloat(float const * x, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        SSE2_FLOAT_LOAD(x0, x1, x + i);
+        acc0 = _mm_max_pd(acc0, sse2Abs(x0));
+        acc1 = _mm_max_pd(acc1, sse2Abs(x1));
+    }
+
+    return std::max(sse2Max(_mm_max_pd(acc0, acc1)), scalarNormInf(x + i, dim - i));
+}
+
+SSE2 double sse2DotFloat(float const * x, float const * y, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        SSE2_FLOAT_LOAD(x0, x1, x + i);
+        SSE2_FLOAT_LOAD(y0, y1, y + i);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(x0, y0));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(x1, y1));
+    }
+
+    return sse2Sum(_mm_add_pd(acc0, acc1)) + scalarDot(x + i, y + i, dim - i);
+}
+
+SSE2 double sse2Distance1Float(float const * x, float const * y, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        SSE2_FLOAT_LOAD(x0, x1, x + i);
+        SSE2_FLOAT_LOAD(y0, y1, y + i);
+        acc0 = _mm_add_pd(acc0, sse2Abs(_mm_sub_pd(x0, y0)));
+        acc1 = _mm_add_pd(acc1, sse2Abs(_mm_sub_pd(x1, y1)));
+    }
+
+    return sse2Sum(_mm_add_pd(acc0, acc1)) + scalarDistance1(x + i, y + i, dim - i);
+}
+
+SSE2 double sse2Distance2SquaredFloat(float const * x, float const * y, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        SSE2_FLOAT_LOAD(x0, x1, x + i);
+        SSE2_FLOAT_LOAD(y0, y1, y + i);
+        __m128d d0 = _mm_sub_pd(x0, y0), d1 = _mm_sub_pd(x1, y1);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(d0, d0));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(d1, d1));
+    }
+
+    return sse2Sum(_mm_add_pd(acc0, acc1)) + scalarDistance2Squared(x + i, y + i, dim - i);
+}
+
+SSE2 double sse2DistanceInfFloat(float const * x, float const * y, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        SSE2_FLOAT_LOAD(x0, x1, x + i);
+        SSE2_FLOAT_LOAD(y0, y1, y + i);
+        acc0 = _mm_max_pd(acc0, sse2Abs(_mm_sub_pd(x0, y0)));
+        acc1 = _mm_max_pd(acc1, sse2Abs(_mm_sub_pd(x1, y1)));
+    }
+
+    return std::max(sse2Max(_mm_max_pd(acc0, acc1)), scalarDistanceInf(x + i, y + i, dim - i));
+}
+
+/* unordered comparison of a value with itself is true only for NaN */
+SSE2 bool sse2HasNaN(double const * x, size_t dim) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 4 <= dim; i += 4) {
+        __m128d x0 = _mm_loadu_pd(x + i), x1 = _mm_loadu_pd(x + i + 2);
+        acc0 = _mm_or_pd(acc0, _mm_cmpunord_pd(x0, x0));
+        acc1 = _mm_or_pd(acc1, _mm_cmpunord_pd(x1, x1));
+    }
+
+    return _mm_movemask_pd(_mm_or_pd(acc0, acc1)) != 0 || scalarHasNaN(x + i, dim - i);
+}
+
+SSE2 bool sse2HasNaNFloat(float const * x, size_t dim) {
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        __m128 x0 = _mm_loadu_ps(x + i), x1 = _mm_loadu_ps(x + i + 4);
+        acc0 = _mm_or_ps(acc0, _mm_cmpunord_ps(x0, x0));
+        acc1 = _mm_or_ps(acc1, _mm_cmpunord_ps(x1, x1));
+    }
+
+    return _mm_movemask_ps(_mm_or_ps(acc0, acc1)) != 0 || scalarHasNaN(x + i, dim - i);
+}
+
+BATCH_KERNELS(sse2, SSE2)
+WEIGHTED_KERNELS(sse2, SSE2)
+
+Kernels const SSE2_KERNELS = {
+    "sse2", sse2Supported,
+    sse2Norm1, sse2Norm2Squared, sse2NormInf, sse2Dot, sse2Distance1, sse2Distance2Squared, sse2DistanceInf,
+    sse2Norm1Float, sse2Norm2SquaredFloat, sse2NormInfFloat, sse2DotFloat, sse2Distance1Float,
+    sse2Distance2SquaredFloat, sse2DistanceInfFloat,
+    sse2WeightedDistance1, sse2WeightedDistance2Squared, sse2WeightedDistanceInf,
+    //widening codes takes SSE4.1, so the scalar versions are used
+    SCALAR_CODE_KERNELS(int8_t), SCALAR_CODE_KERNELS(int16_t),
+    sse2HasNaN, sse2HasNaNFloat,
+    sse2BatchNorm1, sse2BatchNorm2Squared, sse2BatchNormInf, sse2BatchDot, sse2BatchDistance1,
+    sse2BatchDistance2Squared, sse2BatchDistanceInf, sse2BatchTransform
+};
+
+
+
+/* AVX2 */
+
+#define AVX2 __attribute__((target("avx2,fma")))
+
+bool avx2Supported() {
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+AVX2 inline __m256d avx2Abs(__m256d x) {
+    return _mm256_andnot_pd(_mm256_set1_pd(-0.), x);
+}
+
+AVX2 inline double avx2Sum(__m256d x) {
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+
+    return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+}
+
+AVX2 inline double avx2Max(__m256d x) {
+    __m128d half = _mm_max_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+
+    return _mm_cvtsd_f64(_mm_max_sd(half, _mm_unpackhi_pd(half, half)));
+}
+
+AVX2 double avx2Norm1(double const * x, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        acc0 = _mm256_add_pd(acc0, avx2Abs(_mm256_loadu_pd(x + i)));
+        acc1 = _mm256_add_pd(acc1, avx2Abs(_mm256_loadu_pd(x + i + 4)));
+    }
+
+    return avx2Sum(_mm256_add_pd(acc0, acc1)) + scalarNorm1(x + i, dim - i);
+}
+
+AVX2 double avx2Norm2Squared(double const * x, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        __m256d x0 = _mm256_loadu_pd(x + i), x1 = _mm256_loadu_pd(x + i + 4);
+        acc0 = _mm256_fmadd_pd(x0, x0, acc0);
+        acc1 = _mm256_fmadd_pd(x1, x1, acc1);
+    }
+
+    return avx2Sum(_mm256_add_pd(acc0, acc1)) + scalarNorm2Squared(x + i, dim - i);
+}
+
+AVX2 double avx2NormInf(double const * x, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        acc0 = _mm256_max_pd(acc0, avx2Abs(_mm256_loadu_pd(x + i)));
+        acc1 = _mm256_max_pd(acc1, avx2Abs(_mm256_loadu_pd(x + i + 4)));
+    }
+
+    return std::max(avx2Max(_mm256_max_pd(acc0, acc1)), scalarNormInf(x + i, dim - i));
+}
+
+AVX2 double avx2Dot(double const * x, double const * y, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), acc1);
+    }
+
+    return avx2Sum(_mm256_add_pd(acc0, acc1)) + scalarDot(x + i, y + i, dim - i);
+}
+
+AVX2 double avx2Distance1(double const * x, double const * y, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        acc0 = _mm256_add_pd(acc0, avx2Abs(_mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i))));
+        acc1 = _mm256_add_pd(acc1, avx2Abs(_mm256_sub_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4))));
+    }
+
+    return avx2Sum(_mm256_add_pd(acc0, acc1)) + scalarDistance1(x + i, y + i, dim - i);
+}
+
+AVX2 double avx2Distance2Squared(double const * x, double const * y, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i));
+        __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4));
+        acc0 = _mm256_fmadd_pd(d0, d0, acc0);
+        acc1 = _mm256_fmadd_pd(d1, d1, acc1);
+    }
+
+    return avx2Sum(_mm256_add_pd(acc0, acc1)) + scalarDistance2Squared(x + i, y + i, dim - i);
+}
+
+AVX2 double avx2DistanceInf(double const * x, double const * y, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        acc0 = _mm256_max_pd(acc0, avx2Abs(_mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i))));
+        acc1 = _mm256_max_pd(acc1, avx2Abs(_mm256_sub_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4))));
+    }
+
+    return std::max(avx2Max(_mm256_max_pd(acc0, acc1)), scalarDistanceInf(x + i, y + i, dim - i));
+}
+
+/* eight floats are widened to two quadruples of doubles */
+#define AVX2_FLOAT_LOAD(low, high, pointer) \
+    __m256 packed##low = _mm256_loadu_ps(pointer); \
+    __m256d low = _mm256_cvtps_pd(_mm256_castps256_ps128(packed##low)); \
+    __m256d high = _mm256_cvtps_pd(_mm256_extractf128_ps(packed##low, 1))
+
+AVX2 double avx2Norm1Float(float const * x, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        AVX2_FLOAT_LOAD(x0, x1, x + i);
+        acc0 = _mm256_add_pd(acc0, avx2Abs(x0));
+        acc1 = _mm256_add_pd(acc1, avx2Abs(x1));
+    }
+
+    return avx2Sum(_mm256_add_pd(acc0, acc1)) + scalarNorm1(x + i, dim - i);
+}
+
+AVX2 double avx2Norm2SquaredFloat(float const * x, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        AVX2_FLOAT_LOAD(x0, x1, x + i);
+        acc0 = _mm256_fmadd_pd(x0, x0, acc0);
+        acc1 = _mm256_fmadd_pd(x1, x1, acc1);
+    }
+
+    return avx2Sum(_mm256_add_pd(acc0, acc1)) + scalarNorm2Squared(x + i, dim - i);
+}
+
+AVX2 double avx2NormInfFloat(float const * x, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        AVX2_FLOAT_LOAD(x0, x1, x + i);
+        acc0 = _mm256_max_pd(acc0, avx2Abs(x0));
+        acc1 = _mm256_max_pd(acc1, avx2Abs(x1));
+    }
+
+    return std::max(avx2Max(_mm256_max_pd(acc0, acc1)), scalarNormInf(x + i, dim - i));
+}
+
+AVX2 double avx2DotFloat(float const * x, float const * y, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        AVX2_FLOAT_LOAD(x0, x1, x + i);
+        AVX2_FLOAT_LOAD(y0, y1, y + i);
+        acc0 = _mm256_fmadd_pd(x0, y0, acc0);
+        acc1 = _mm256_fmadd_pd(x1, y1, acc1);
+    }
+
+    return avx2Sum(_mm256_add_pd(acc0, acc1)) + scalarDot(x + i, y + i, dim - i);
+}
+
+AVX2 double avx2Distance1Float(float const * x, float const * y, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        AVX2_FLOAT_LOAD(x0, x1, x + i);
+        AVX2_FLOAT_LOAD(y0, y1, y + i);
+        acc0 = _mm256_add_pd(acc0, avx2Abs(_mm256_sub_pd(x0, y0)));
+        acc1 = _mm256_add_pd(acc1, avx2Abs(_mm256_sub_pd(x1, y1)));
+    }
+
+    return avx2Sum(_mm256_add_pd(acc0, acc1)) + scalarDistance1(x + i, y + i, dim - i);
+}
+
+AVX2 double avx2Distance2SquaredFloat(float const * x, float const * y, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        AVX2_FLOAT_LOAD(x0, x1, x + i);
+        AVX2_FLOAT_LOAD(y0, y1, y + i);
+        __m256d d0 = _mm256_sub_pd(x0, y0), d1 = _mm256_sub_pd(x1, y1);
+        acc0 = _mm256_fmadd_pd(d0, d0, acc0);
+        acc1 = _mm256_fmadd_pd(d1, d1, acc1);
+    }
+
+    return avx2Sum(_mm256_add_pd(acc0, acc1)) + scalarDistance2Squared(x + i, y + i, dim - i);
+}
+
+AVX2 double avx2DistanceInfFloat(float const * x, float const * y, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        AVX2_FLOAT_LOAD(x0, x1, x + i);
+        AVX2_FLOAT_LOAD(y0, y1, y + i);
+        acc0 = _mm256_max_pd(acc0, avx2Abs(_mm256_sub_pd(x0, y0)));
+        acc1 = _mm256_max_pd(acc1, avx2Abs(_mm256_sub_pd(x1, y1)));
+    }
+
+    return std::max(avx2Max(_mm256_max_pd(acc0, acc1)), scalarDistanceInf(x + i, y + i, dim - i));
+}
+
+AVX2 bool avx2HasNaN(double const * x, size_t dim) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        __m256d x0 = _mm256_loadu_pd(x + i), x1 = _mm256_loadu_pd(x + i + 4);
+        acc0 = _mm256_or_pd(acc0, _mm256_cmp_pd(x0, x0, _CMP_UNORD_Q));
+        acc1 = _mm256_or_pd(acc1, _mm256_cmp_pd(x1, x1, _CMP_UNORD_Q));
+    }
+
+    return _mm256_movemask_pd(_mm256_or_pd(acc0, acc1)) != 0 || scalarHasNaN(x + i, dim - i);
+}
+
+AVX2 bool avx2HasNaNFloat(float const * x, size_t dim) {
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+
+    for(; i + 16 <= dim; i += 16) {
+        __m256 x0 = _mm256_loadu_ps(x + i), x1 = _mm256_loadu_ps(x + i + 8);
+        acc0 = _mm256_or_ps(acc0, _mm256_cmp_ps(x0, x0, _CMP_UNORD_Q));
+        acc1 = _mm256_or_ps(acc1, _mm256_cmp_ps(x1, x1, _CMP_UNORD_Q));
+    }
+
+    return _mm256_movemask_ps(_mm256_or_ps(acc0, acc1)) != 0 || scalarHasNaN(x + i, dim - i);
+}
+
+/* codes are sign-extended to 32 bits and then converted, four at a time */
+struct Avx2Decode {
+    typedef __m256d Lanes;
+
+    AVX2 static void load(int8_t const * codes, Lanes & lanes) {
+        int32_t packed;
+
+        memcpy(&packed, codes, sizeof(packed));
+        lanes = _mm256_cvtepi32_pd(_mm_cvtepi8_epi32(_mm_cvtsi32_si128(packed)));
+    }
+
+    AVX2 static void load(int16_t const * codes, Lanes & lanes) {
+        lanes = _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_loadl_epi64((__m128i const *) codes)));
+    }
+};
+
+BATCH_KERNELS(avx2, AVX2)
+CODE_KERNELS(avx2, AVX2, Avx2Decode)
+WEIGHTED_KERNELS(avx2, AVX2)
+
+Kernels const AVX2_KERNELS = {
+    "avx2", avx2Supported,
+    avx2Norm1, avx2Norm2Squared, avx2NormInf, avx2Dot, avx2Distance1, avx2Distance2Squared, avx2DistanceInf,
+    avx2Norm1Float, avx2Norm2SquaredFloat, avx2NormInfFloat, avx2DotFloat, avx2Distance1Float,
+    avx2Distance2SquaredFloat, avx2DistanceInfFloat,
+    avx2WeightedDistance1, avx2WeightedDistance2Squared, avx2WeightedDistanceInf,
+    CODE_KERNELS_TABLE(avx2),
+    avx2HasNaN, avx2HasNaNFloat,
+    avx2BatchNorm1, avx2BatchNorm2Squared, avx2BatchNormInf, avx2BatchDot, avx2BatchDistance1,
+    avx2BatchDistance2Squared, avx2BatchDistanceInf, avx2BatchTransform
+};
+
+
+
+/* AVX-512 */
+
+#define AVX512 __attribute__((target("avx512f")))
+
+bool avx512Supported() {
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("avx512f");
+}
+
+AVX512 inline __mmask8 avx512TailMask(size_t rest) {
+    return (__mmask8) ((1u << rest) - 1);
+}
+
+AVX512 double avx512Norm1(double const * x, size_t dim) {
+    __m512d acc = _mm512_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        acc = _mm512_add_pd(acc, _mm512_abs_pd(_mm512_loadu_pd(x + i)));
+    }
+
+    if(i < dim) {
+        acc = _mm512_add_pd(acc, _mm512_abs_pd(_mm512_maskz_loadu_pd(avx512TailMask(dim - i), x + i)));
+    }
+
+    return _mm512_reduce_add_pd(acc);
+}
+
+AVX512 double avx512Norm2Squared(double const * x, size_t dim) {
+    __m512d acc = _mm512_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        __m512d x0 = _mm512_loadu_pd(x + i);
+        acc = _mm512_fmadd_pd(x0, x0, acc);
+    }
+
+    if(i < dim) {
+        __m512d x0 = _mm512_maskz_loadu_pd(avx512TailMask(dim - i), x + i);
+        acc = _mm512_fmadd_pd(x0, x0, acc);
+    }
+
+    return _mm512_reduce_add_pd(acc);
+}
+
+AVX512 double avx512NormInf(double const * x, size_t dim) {
+    __m512d acc = _mm512_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        acc = _mm512_max_pd(acc, _mm512_abs_pd(_mm512_loadu_pd(x + i)));
+    }
+
+    if(i < dim) {
+        acc = _mm512_max_pd(acc, _mm512_abs_pd(_mm512_maskz_loadu_pd(avx512TailMask(dim - i), x + i)));
+    }
+
+    return _mm512_reduce_max_pd(acc);
+}
+
+AVX512 double avx512Dot(double const * x, double const * y, size_t dim) {
+    __m512d acc = _mm512_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        acc = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), acc);
+    }
+
+    if(i < dim) {
+        __mmask8 mask = avx512TailMask(dim - i);
+        acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i), acc);
+    }
+
+    return _mm512_reduce_add_pd(acc);
+}
+
+AVX512 double avx512Distance1(double const * x, double const * y, size_t dim) {
+    __m512d acc = _mm512_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        acc = _mm512_add_pd(acc, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i))));
+    }
+
+    if(i < dim) {
+        __mmask8 mask = avx512TailMask(dim - i);
+        __m512d diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+        acc = _mm512_add_pd(acc, _mm512_abs_pd(diff));
+    }
+
+    return _mm512_reduce_add_pd(acc);
+}
+
+AVX512 double avx512Distance2Squared(double const * x, double const * y, size_t dim) {
+    __m512d acc = _mm512_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        __m512d diff = _mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i));
+        acc = _mm512_fmadd_pd(diff, diff, acc);
+    }
+
+    if(i < dim) {
+        __mmask8 mask = avx512TailMask(dim - i);
+        __m512d diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+        acc = _mm512_fmadd_pd(diff, diff, acc);
+    }
+
+    return _mm512_reduce_add_pd(acc);
+}
+
+AVX512 double avx512DistanceInf(double const * x, double const * y, size_t dim) {
+    __m512d acc = _mm512_setzero_pd();
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        acc = _mm512_max_pd(acc, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i))));
+    }
+
+    if(i < dim) {
+        __mmask8 mask = avx512TailMask(dim - i);
+        __m512d diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+        acc = _mm512_max_pd(acc, _mm512_abs_pd(diff));
+    }
+
+    return _mm512_reduce_max_pd(acc);
+}
+
+//single precision gains little from wider registers once widened to double, the AVX2 versions are reused
+AVX512 bool avx512HasNaN(double const * x, size_t dim) {
+    __mmask8 found = 0;
+    size_t i = 0;
+
+    for(; i + 8 <= dim; i += 8) {
+        __m512d x0 = _mm512_loadu_pd(x + i);
+        found |= _mm512_cmp_pd_mask(x0, x0, _CMP_UNORD_Q);
+    }
+
+    if(i < dim) {
+        __m512d x0 = _mm512_maskz_loadu_pd(avx512TailMask(dim - i), x + i);
+        found |= _mm512_cmp_pd_mask(x0, x0, _CMP_UNORD_Q);
+    }
+
+    return found != 0;
+}
+
+/* the same, eight at a time */
+struct Avx512Decode {
+    typedef __m512d Lanes;
+
+    AVX512 static void load(int8_t const * codes, Lanes & lanes) {
+        lanes = _mm512_cvtepi32_pd(_mm256_cvtepi8_epi32(_mm_loadl_epi64((__m128i const *) codes)));
+    }
+
+    AVX512 static void load(int16_t const * codes, Lanes & lanes) {
+        lanes = _mm512_cvtepi32_pd(_mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i const *) codes)));
+    }
+};
+
+BATCH_KERNELS(avx512, AVX512)
+CODE_KERNELS(avx512, AVX512, Avx512Decode)
+WEIGHTED_KERNELS(avx512, AVX512)
+
+Kernels const AVX512_KERNELS = {
+    "avx512f", avx512Supported,
+    avx512Norm1, avx512Norm2Squared, avx512NormInf, avx512Dot, avx512Distance1, avx512Distance2Squared,
+    avx512DistanceInf,
+    avx2Norm1Float, avx2Norm2SquaredFloat, avx2NormInfFloat, avx2DotFloat, avx2Distance1Float,
+    avx2Distance2SquaredFloat, avx2DistanceInfFloat,
+    avx512WeightedDistance1, avx512WeightedDistance2Squared, avx512WeightedDistanceInf,
+    CODE_KERNELS_TABLE(avx512),
+    avx512HasNaN, avx2HasNaNFloat,
+    avx512BatchNorm1, avx512BatchNorm2Squared, avx512BatchNormInf, avx512BatchDot, avx512BatchDistance1,
+    avx512BatchDistance2Squared, avx512BatchDistanceInf, avx512BatchTransform
+};
+#endif
+
+
+
+/* Dispatch */
+
+Kernels const * const BACKENDS[] = {
+    &SCALAR,
+#ifdef KERNELS_X86
+    &SSE2_KERNELS,
+    &AVX2_KERNELS,
+    &AVX512_KERNELS,
+#endif
+};
+
+size_t const BACKENDS_COUNT = sizeof(BACKENDS) / sizeof(BACKENDS[0]);
+
+Kernels const * select() {
+    Kernels const * best = &SCALAR;
+
+    for(size_t i = 0; i < BACKENDS_COUNT; ++i) {
+        if(BACKENDS[i]->isSupported()) {
+            best = BACKENDS[i];
+        }
+    }
+
+    return best;
+}
+}
+
+
+
+Kernels const & Kernels::get() {
+    //initialized once on the first call, which concurrent first calls wait for, whatever the order of initialization
+    static Kernels const * active = select();
+
+    return *active;
+}
+
+Kernels const & Kernels::reference() {
+    return SCALAR;
+}
+
+size_t Kernels::getBackendsCount() {
+    return BACKENDS_COUNT;
+}
+
+Kernels const & Kernels::getBackend(size_t index) {
+    return index < BACKENDS_COUNT ? *BACKENDS[index] : SCALAR;
+}
@@ -0,0 +1,72 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+
+/* Dense coordinate kernels, one table per instruction set */
+struct Kernels {
+    char const * name;
+    bool (* isSupported)();
+
+    double (* norm1)(double const * x, size_t dim);
+    double (* norm2Squared)(double const * x, size_t dim);
+    double (* normInf)(double const * x, size_t dim);
+    double (* dot)(double const * x, double const * y, size_t dim);
+    double (* distance1)(double const * x, double const * y, size_t dim);
+    double (* distance2Squared)(double const * x, double const * y, size_t dim);
+    double (* distanceInf)(double const * x, double const * y, size_t dim);
+
+    //single precision storage, accumulated in double precision
+    double (* norm1Float)(float const * x, size_t dim);
+    double (* norm2SquaredFloat)(float const * x, size_t dim);
+    double (* normInfFloat)(float const * x, size_t dim);
+    double (* dotFloat)(float const * x, float const * y, size_t dim);
+    double (* distance1Float)(float const * x, float const * y, size_t dim);
+    double (* distance2SquaredFloat)(float const * x, float const * y, size_t dim);
+    double (* distanceInfFloat)(float const * x, float const * y, size_t dim);
+
+    //coordinate i of the difference is multiplied by w[i] before it is accumulated
+    double (* weightedDistance1)(double const * x, double const * y, double const * w, size_t dim);
+    double (* weightedDistance2Squared)(double const * x, double const * y, double const * w, size_t dim);
+    double (* weightedDistanceInf)(double const * x, double const * y, double const * w, size_t dim);
+
+    //distances from a query to codes decoded as offset + scale * code, the codes are widened in registers
+    double (* codeDistance1Int8)(double const * query, int8_t const * codes, double scale, double offset, size_t dim);
+    double (* codeDistance2SquaredInt8)(double const * query, int8_t const * codes, double scale, double offset,
+                                        size_t dim);
+    double (* codeDistanceInfInt8)(double const * query, int8_t const * codes, double scale, double offset, size_t dim);
+    double (* codeDistance1Int16)(double const * query, int16_t const * codes, double scale, double offset, size_t dim);
+    double (* codeDistance2SquaredInt16)(double const * query, int16_t const * codes, double scale, double offset,
+                                         size_t dim);
+    double (* codeDistanceInfInt16)(double const * query, int16_t const * codes, double scale, double offset,
+                                    size_t dim);
+
+    //validation of coordinates before they become a vector
+    bool (* hasNaN)(double const * x, size_t dim);
+    bool (* hasNaNFloat)(float const * x, size_t dim);
+
+    //one block of BATCH_LANES vectors stored coordinate-major, block[j * BATCH_LANES + lane], one result per lane
+    static size_t const BATCH_LANES = 8;
+    void (* batchNorm1)(double const * block, size_t dim, double * result);
+    void (* batchNorm2Squared)(double const * block, size_t dim, double * result);
+    void (* batchNormInf)(double const * block, size_t dim, double * result);
+    void (* batchDot)(double const * block, double const * query, size_t dim, double * result);
+    void (* batchDistance1)(double const * block, double const * query, size_t dim, double * result);
+    void (* batchDistance2Squared)(double const * block, double const * query, size_t dim, double * result);
+    void (* batchDistanceInf)(double const * block, double const * query, size_t dim, double * result);
+    //rows x cols row-major matrix times one block of cols coordinates, result is a block of rows coordinates
+    void (* batchTransform)(double const * matrix, size_t rows, size_t cols, double const * block, double * result);
+
+    //the best table supported by the CPU, selected once when the library is loaded
+    static Kernels const & get();
+    //scalar reference table
+    static Kernels const & reference();
+
+    static size_t getBackendsCount();
+    static Kernels const & getBackend(size_t index);
+};
+
+#endif // KERNELS_H
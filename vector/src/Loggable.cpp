@@ -0,0 +1,51 @@
+#include <string.h>
+
+#include "Loggable.h"
+
+
+
+Loggable::Loggable(ILogger * pLogger) : logger(pLogger) {}
+
+Loggable::~Loggable() = default;
+
+RESULT_CODE Loggable::printFormatted(FILE * logStream, char const * pMsg, RESULT_CODE err) {
+    fprintf(logStream, "%s: %s\n", ErrorName[(int) err], pMsg);
+
+    return err;
+}
+
+RESULT_CODE Loggable::printLog(char const * pMsg, RESULT_CODE err, ILogger * pLogger) {
+    if(pLogger != nullptr) {
+        pLogger->log(pMsg, err);
+    } else {
+        printFormatted(stderr, pMsg, err);
+    }
+
+    return err;
+}
+
+RESULT_CODE Loggable::printLogDuring(char const * pMsg, char const * during, RESULT_CODE err, ILogger * pLogger) {
+    char result[1024] = "";
+
+    strcat(result, pMsg);
+    strcat(result, " during \"");
+    strcat(result, during);
+    strcat(result, "\"");
+
+    return printLog(result, err, pLogger);
+}
+
+char const Loggable::ErrorName[][30] = {
+    "SUCCESS",
+    "OUT_OF_MEMORY",
+    "BAD_REFERENCE",
+    "WRONG_DIM",
+    "DIVISION_BY_ZERO",
+    "NAN_VALUE",
+    "FILE_ERROR",
+    "OUT_OF_BOUNDS",
+    "NOT_FOUND",
+    "WRONG_ARGUMENT",
+    "CALCULATION_ERROR",
+    "MULTIPLE_DEFINITION"
+};
@@ -0,0 +1,26 @@
+#ifndef LOGGABLE_H
+#define LOGGABLE_H
+
+#include <cstdio>
+
+#include "../include/ILogger.h"
+
+
+
+class Loggable {
+public:
+    explicit Loggable(ILogger * pLogger);
+    virtual ~Loggable() = 0;
+    static RESULT_CODE printLog(char const * pMsg, RESULT_CODE err, ILogger * pLogger);
+    static RESULT_CODE printLogDuring(char const * pMsg, char const * during, RESULT_CODE err, ILogger * pLogger);
+
+    static char const ErrorName[][30];
+    ILogger * logger;
+
+private:
+    Loggable() = delete;
+
+    static RESULT_CODE printFormatted(FILE * logStream, char const * pMsg, RESULT_CODE err);
+};
+
+#endif // LOGGABLE_H
@@ -0,0 +1,478 @@
+#include <cmath>
+#include <mem.h>
+#include <limits>
+#include <algorithm>
+#include <new>
+#include <atomic>
+#include <vector>
+
+#include "../include/IMatrix.h"
+#include "Kernels.h"
+#include "Loggable.h"
+#include "WorkerPool.h"
+
+
+
+namespace {
+class Matrix : public IMatrix, private Loggable {
+public:
+    ~Matrix() override;
+    IMatrix * clone() const override;
+    size_t getRows() const override;
+    size_t getCols() const override;
+    double getCoord(size_t row, size_t col) const override;
+    RESULT_CODE setCoord(size_t row, size_t col, double value) override;
+    double const * getData() const override;
+    double const * getTranslation() const override;
+    RESULT_CODE setTranslation(double const * pTranslation) override;
+
+    //zero matrix, with a zero translation if translated is true
+    static Matrix * createMatrix(size_t rows, size_t cols, bool translated, char const * during, ILogger * pLogger);
+    double * getMutableData();
+    double * getMutableTranslation();
+
+private:
+    Matrix(size_t rows, size_t cols, ILogger * pLogger);
+    Matrix(Matrix const & anotherMatrix) = delete;
+    Matrix & operator = (Matrix const & anotherMatrix) = delete;
+
+    size_t rows;
+    size_t cols;
+    double * coords;
+    //nullptr for a linear map
+    double * translation;
+};
+
+//fewer multiply-adds than this are not worth starting threads
+size_t const PARALLEL_WORK = 1 << 20;
+//blocks of a batch transformed by one task
+size_t const TASK_BLOCKS = 16;
+
+
+/* Secondary functions */
+
+/* input coordinates as one array, copied into buffer if the vector does not keep them so */
+double const * vectorCoords(IVector const * pVector, std::vector <double> & buffer) {
+    double const * coords = pVector->getData();
+
+    if(coords != nullptr) {
+        return coords;
+    }
+
+    buffer.resize(pVector->getDim());
+
+    for(size_t i = 0; i < buffer.size(); ++i) {
+        buffer[i] = pVector->getCoord(i);
+    }
+
+    return buffer.data();
+}
+
+/* bound on the absolute values of the transformed coordinates, size interleaved coordinates of the batch are read;
+   infinite or NaN if a coordinate may overflow */
+double resultBound(IMatrix const * pMatrix, double const * input, size_t size) {
+    Kernels const & kernels = Kernels::get();
+    size_t rows = pMatrix->getRows(), cols = pMatrix->getCols();
+    double const * translation = pMatrix->getTranslation();
+    double largest = kernels.normInf(input, size);
+    double bound = 0.;
+
+    for(size_t i = 0; i < rows; ++i) {
+        double row = kernels.norm1(pMatrix->getData() + i * cols, cols) * largest +
+                (translation != nullptr ? std::fabs(translation[i]) : 0.);
+
+        //NaN is kept
+        if(!(row <= bound)) {
+            bound = row;
+        }
+    }
+
+    return bound;
+}
+
+/* blocks [firstBlock, lastBlock) of the batch, scratch holds one result block when the batch is transformed in place
+   or when output is nullptr, in which case the blocks are only checked; returns false if a NaN coordinate was obtained */
+bool transformBlocks(IMatrix const * pMatrix, double const * input, double * output, size_t count, size_t firstBlock,
+                     size_t lastBlock, double * scratch) {
+    size_t const LANES = IVectorBatch::LANES;
+    Kernels const & kernels = Kernels::get();
+    size_t rows = pMatrix->getRows(), cols = pMatrix->getCols();
+    double const * translation = pMatrix->getTranslation();
+    bool nanFound = false;
+
+    for(size_t block = firstBlock; block < lastBlock; ++block) {
+        double * out = scratch != nullptr ? scratch : output + block * LANES * rows;
+        //padding lanes stay zero, as the matrix only multiplies them
+        size_t lanes = std::min(LANES, count - block * LANES);
+
+        kernels.batchTransform(pMatrix->getData(), rows, cols, input + block * LANES * cols, out);
+
+        for(size_t i = 0; i < rows; ++i) {
+            for(size_t lane = 0; lane < lanes; ++lane) {
+                out[i * LANES + lane] += translation != nullptr ? translation[i] : 0.;
+                nanFound |= std::isnan(out[i * LANES + lane]);
+            }
+        }
+
+        if(scratch != nullptr && output != nullptr) {
+            memcpy(output + block * LANES * rows, scratch, rows * LANES * sizeof(double));
+        }
+    }
+
+    return !nanFound;
+}
+
+RESULT_CODE mulBatch(IMatrix const * pMatrix, IVectorBatch const * pBatch, IVectorBatch * pResult,
+                     char const * during, ILogger * pLogger) {
+    size_t const LANES = IVectorBatch::LANES;
+
+    if(pMatrix == nullptr || pBatch == nullptr || pResult == nullptr) {
+        return Loggable::printLogDuring("Matrix or batch turned out to be equal to nullptr", during,
+                                        RESULT_CODE::BAD_REFERENCE, pLogger);
+    }
+
+    size_t rows = pMatrix->getRows(), cols = pMatrix->getCols(), count = pBatch->getCount();
+
+    if(pBatch->getDim() != cols || pResult->getDim() != rows || pResult->getCount() != count) {
+        return Loggable::printLogDuring("The dimensions of the matrix and the batches do not match", during,
+                                        RESULT_CODE::WRONG_DIM, pLogger);
+    }
+
+    size_t blocks = (count + LANES - 1) / LANES;
+    size_t tasks = (blocks + TASK_BLOCKS - 1) / TASK_BLOCKS;
+    //every block is read completely before its result is written, one scratch block per task
+    bool inPlace = pResult == pBatch;
+    double const * input = pBatch->getData();
+    //with a finite bound no coordinate overflows, so none is NaN; otherwise a pass that writes nothing checks first
+    bool checkFirst = !std::isfinite(2. * resultBound(pMatrix, input, blocks * LANES * cols));
+    double * output = nullptr;
+    std::vector <double> scratch;
+    std::atomic <bool> nanFound(false);
+
+    try {
+        scratch.resize(inPlace || checkFirst ? tasks * rows * LANES : 0);
+    } catch(std::bad_alloc const &) {
+        return Loggable::printLogDuring("Not enough memory for the transform", during, RESULT_CODE::OUT_OF_MEMORY,
+                                        pLogger);
+    }
+
+    auto task = [&](size_t t) {
+        size_t firstBlock = t * TASK_BLOCKS;
+        double * taskScratch = inPlace || output == nullptr ? scratch.data() + t * rows * LANES : nullptr;
+
+        if(!transformBlocks(pMatrix, input, output, count, firstBlock, std::min(blocks, firstBlock + TASK_BLOCKS),
+                            taskScratch)) {
+            nanFound.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    for(int pass = checkFirst ? 0 : 1; pass < 2 && !nanFound.load(); ++pass) {
+        bool parallel = tasks > 1 && count * rows * cols >= PARALLEL_WORK;
+
+        output = pass == 0 ? nullptr : pResult->getMutableData();
+
+        try {
+            if(parallel) {
+                WorkerPool::get().run(tasks, task);
+            }
+        } catch(std::bad_alloc const &) {
+            //the tasks are run one after another below
+            parallel = false;
+        }
+
+        for(size_t t = 0; t < tasks && !parallel; ++t) {
+            task(t);
+        }
+    }
+
+    if(nanFound.load()) {
+        return Loggable::printLogDuring("NaN coordinate would be obtained, the result batch is left unchanged", during,
+                                        RESULT_CODE::CALCULATION_ERROR, pLogger);
+    }
+
+    return RESULT_CODE::SUCCESS;
+}
+}
+
+
+
+/* IMatrix */
+
+IMatrix::~IMatrix() = default;
+
+IMatrix * IMatrix::createMatrix(size_t rows, size_t cols, double const * pData, double const * pTranslation,
+                                ILogger * pLogger) {
+    char const * during = "IMatrix::createMatrix";
+
+    if(pData == nullptr) {
+        Loggable::printLogDuring("Trying to create a matrix with nullptr coordinates", during,
+                                 RESULT_CODE::BAD_REFERENCE, pLogger);
+
+        return nullptr;
+    }
+
+    if(IVector::hasNaN(pData, rows * cols) || (pTranslation != nullptr && IVector::hasNaN(pTranslation, rows))) {
+        Loggable::printLogDuring("NaN matrix component was found", during, RESULT_CODE::NAN_VALUE, pLogger);
+
+        return nullptr;
+    }
+
+    Matrix * matrix = Matrix::createMatrix(rows, cols, pTranslation != nullptr, during, pLogger);
+
+    if(matrix != nullptr) {
+        memcpy(matrix->getMutableData(), pData, rows * cols * sizeof(double));
+
+        if(pTranslation != nullptr) {
+            memcpy(matrix->getMutableTranslation(), pTranslation, rows * sizeof(double));
+        }
+    }
+
+    return matrix;
+}
+
+IMatrix * IMatrix::createIdentity(size_t dim, ILogger * pLogger) {
+    Matrix * matrix = Matrix::createMatrix(dim, dim, false, "IMatrix::createIdentity", pLogger);
+
+    for(size_t i = 0; matrix != nullptr && i < dim; ++i) {
+        matrix->getMutableData()[i * dim + i] = 1.;
+    }
+
+    return matrix;
+}
+
+IMatrix * IMatrix::mul(IMatrix const * pOperand1, IMatrix const * pOperand2, ILogger * pLogger) {
+    char const * during = "IMatrix::mul";
+
+    if(pOperand1 == nullptr || pOperand2 == nullptr) {
+        Loggable::printLogDuring("Operand turned out to be equal to nullptr", during, RESULT_CODE::BAD_REFERENCE,
+                                 pLogger);
+
+        return nullptr;
+    }
+
+    size_t rows = pOperand1->getRows(), inner = pOperand1->getCols(), cols = pOperand2->getCols();
+
+    if(inner != pOperand2->getRows()) {
+        Loggable::printLogDuring("The columns of the first matrix do not match the rows of the second one", during,
+                                 RESULT_CODE::WRONG_DIM, pLogger);
+
+        return nullptr;
+    }
+
+    double const * a = pOperand1->getData();
+    double const * b = pOperand2->getData();
+    double const * translation1 = pOperand1->getTranslation();
+    double const * translation2 = pOperand2->getTranslation();
+    Matrix * matrix = Matrix::createMatrix(rows, cols, translation1 != nullptr || translation2 != nullptr, during,
+                                           pLogger);
+
+    if(matrix == nullptr) {
+        return nullptr;
+    }
+
+    double * c = matrix->getMutableData();
+    double * translation = matrix->getMutableTranslation();
+
+    //rows of b are added up, so the inner loop runs along contiguous memory
+    for(size_t i = 0; i < rows; ++i) {
+        for(size_t k = 0; k < inner; ++k) {
+            for(size_t j = 0; j < cols; ++j) {
+                c[i * cols + j] += a[i * inner + k] * b[k * cols + j];
+            }
+
+            if(translation2 != nullptr) {
+                translation[i] += a[i * inner + k] * translation2[k];
+            }
+        }
+
+        if(translation1 != nullptr) {
+            translation[i] += translation1[i];
+        }
+    }
+
+    if(IVector::hasNaN(c, rows * cols) || (translation != nullptr && IVector::hasNaN(translation, rows))) {
+        Loggable::printLogDuring("NaN component was obtained", during, RESULT_CODE::CALCULATION_ERROR, pLogger);
+
+        delete matrix;
+        matrix = nullptr;
+    }
+
+    return matrix;
+}
+
+IVector * IMatrix::mul(IMatrix const * pMatrix, IVector const * pVector, ILogger * pLogger) {
+    char const * during = "IMatrix::mul";
+
+    if(pMatrix == nullptr || pVector == nullptr) {
+        Loggable::printLogDuring("Matrix or vector turned out to be equal to nullptr", during,
+                                 RESULT_CODE::BAD_REFERENCE, pLogger);
+
+        return nullptr;
+    }
+
+    size_t rows = pMatrix->getRows(), cols = pMatrix->getCols();
+
+    if(pVector->getDim() != cols) {
+        Loggable::printLogDuring("The dimensions of the matrix and the vector do not match", during,
+                                 RESULT_CODE::WRONG_DIM, pLogger);
+
+        return nullptr;
+    }
+
+    Kernels const & kernels = Kernels::get();
+    double const * translation = pMatrix->getTranslation();
+    std::vector <double> buffer, result;
+
+    try {
+        double const * x = vectorCoords(pVector, buffer);
+
+        result.resize(rows);
+
+        for(size_t i = 0; i < rows; ++i) {
+            result[i] = kernels.dot(pMatrix->getData() + i * cols, x, cols) +
+                    (translation != nullptr ? translation[i] : 0.);
+        }
+    } catch(std::bad_alloc const &) {
+        Loggable::printLogDuring("Not enough memory for the product", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+
+        return nullptr;
+    }
+
+    if(IVector::hasNaN(result.data(), rows)) {
+        Loggable::printLogDuring("NaN coordinate was obtained", during, RESULT_CODE::CALCULATION_ERROR, pLogger);
+
+        return nullptr;
+    }
+
+    return IVector::createTrustedVector(rows, result.data(), pLogger);
+}
+
+RESULT_CODE IMatrix::mul(IMatrix const * pMatrix, IVectorBatch const * pBatch, IVectorBatch * pResult,
+                         ILogger * pLogger) {
+    return mulBatch(pMatrix, pBatch, pResult, "IMatrix::mul", pLogger);
+}
+
+RESULT_CODE IMatrix::transform(IMatrix const * pMatrix, IVectorBatch * pBatch, ILogger * pLogger) {
+    return mulBatch(pMatrix, pBatch, pBatch, "IMatrix::transform", pLogger);
+}
+
+
+
+/* Matrix */
+
+Matrix::Matrix(size_t rows, size_t cols, ILogger * pLogger) : IMatrix(), Loggable(pLogger), rows(rows), cols(cols),
+    coords(nullptr), translation(nullptr) {}
+
+Matrix::~Matrix() {
+    delete [] coords;
+    delete [] translation;
+
+    coords = nullptr;
+    translation = nullptr;
+}
+
+Matrix * Matrix::createMatrix(size_t rows, size_t cols, bool translated, char const * during, ILogger * pLogger) {
+    if(rows == 0 || cols == 0) {
+        printLogDuring("Trying to create a matrix without rows or columns", during, RESULT_CODE::WRONG_DIM, pLogger);
+
+        return nullptr;
+    }
+
+    Matrix * matrix = new (std::nothrow) Matrix(rows, cols, pLogger);
+
+    if(matrix != nullptr) {
+        matrix->coords = new (std::nothrow) double[rows * cols]();
+        matrix->translation = translated ? new (std::nothrow) double[rows]() : nullptr;
+    }
+
+    if(matrix == nullptr || matrix->coords == nullptr || (translated && matrix->translation == nullptr)) {
+        printLogDuring("Not enough memory to create the matrix", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+
+        delete matrix;
+        matrix = nullptr;
+    }
+
+    return matrix;
+}
+
+IMatrix * Matrix::clone() const {
+    return IMatrix::createMatrix(rows, cols, coords, translation, logger);
+}
+
+size_t Matrix::getRows() const {
+    return rows;
+}
+
+size_t Matrix::getCols() const {
+    return cols;
+}
+
+double Matrix::getCoord(size_t row, size_t col) const {
+    if(row >= rows || col >= cols) {
+        printLogDuring("Index of matrix component out of bounds", "IMatrix::getCoord", RESULT_CODE::OUT_OF_BOUNDS,
+                       logger);
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    return coords[row * cols + col];
+}
+
+RESULT_CODE Matrix::setCoord(size_t row, size_t col, double value) {
+    char const * during = "IMatrix::setCoord";
+
+    if(row >= rows || col >= cols) {
+        return printLogDuring("Index of matrix component out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+    }
+
+    if(std::isnan(value)) {
+        return printLogDuring("Matrix component is equal to NaN", during, RESULT_CODE::NAN_VALUE, logger);
+    }
+
+    coords[row * cols + col] = value;
+
+    return RESULT_CODE::SUCCESS;
+}
+
+double const * Matrix::getData() const {
+    return coords;
+}
+
+double * Matrix::getMutableData() {
+    return coords;
+}
+
+double const * Matrix::getTranslation() const {
+    return translation;
+}
+
+double * Matrix::getMutableTranslation() {
+    return translation;
+}
+
+RESULT_CODE Matrix::setTranslation(double const * pTranslation) {
+    char const * during = "IMatrix::setTranslation";
+
+    if(pTranslation == nullptr) {
+        delete [] translation;
+        translation = nullptr;
+
+        return RESULT_CODE::SUCCESS;
+    }
+
+    if(IVector::hasNaN(pTranslation, rows)) {
+        return printLogDuring("NaN translation component was found", during, RESULT_CODE::NAN_VALUE, logger);
+    }
+
+    if(translation == nullptr) {
+        translation = new (std::nothrow) double[rows];
+    }
+
+    if(translation == nullptr) {
+        return printLogDuring("Not enough memory for the translation", during, RESULT_CODE::OUT_OF_MEMORY, logger);
+    }
+
+    memcpy(translation, pTranslation, rows * sizeof(double));
+
+    return RESULT_CODE::SUCCESS;
+}
@@ -0,0 +1,394 @@
+#include <cmath>
+#include <mem.h>
+#include <limits>
+#include <algorithm>
+#include <new>
+
+#include "../include/INorm.h"
+#include "Kernels.h"
+#include "Loggable.h"
+
+
+
+namespace {
+class Norm : public INorm, private Loggable {
+public:
+    ~Norm() override;
+    INorm * clone() const override;
+    double getP() const override;
+    size_t getDim() const override;
+    double const * getWeights() const override;
+    double norm(IVector const * pVector) const override;
+
+    //pWeights is nullptr for an unweighted norm
+    static Norm * createNorm(double p, size_t dim, double const * pWeights, char const * during, ILogger * pLogger);
+
+private:
+    Norm(double p, size_t dim, ILogger * pLogger);
+    Norm(Norm const & anotherNorm) = delete;
+    Norm & operator = (Norm const & anotherNorm) = delete;
+
+    double p;
+    size_t dim;
+    double * weights;
+};
+
+//coordinates passed to one kernel call, the tolerance is checked between the calls
+size_t const CHUNK = 1024;
+
+
+/* Secondary functions */
+
+/* the same norm as IVector::NORM, false if there is none */
+bool standardNorm(INorm const * pNorm, IVector::NORM & norm) {
+    double p = pNorm->getP();
+
+    if(pNorm->getWeights() != nullptr) {
+        return false;
+    }
+
+    norm = p == 1. ? IVector::NORM::NORM_1 : p == 2. ? IVector::NORM::NORM_2 : IVector::NORM::NORM_INF;
+
+    return p == 1. || p == 2. || std::isinf(p);
+}
+
+/* coordinates [begin, begin + count) copied into buffer, zeros for nullptr */
+double const * chunkCoords(IVector const * pVector, size_t begin, size_t count, double * buffer) {
+    for(size_t i = 0; i < count; ++i) {
+        buffer[i] = pVector == nullptr ? 0. : pVector->getCoord(begin + i);
+    }
+
+    return buffer;
+}
+
+/* sum of |w_i (x_i - y_i)|^p for p equal to 1 or 2, the maximum for infinite p; w may be nullptr */
+double chunkPowered(double p, double const * x, double const * y, double const * w, size_t count) {
+    Kernels const & kernels = Kernels::get();
+
+    if(p == 1.) {
+        return w != nullptr ? kernels.weightedDistance1(x, y, w, count) : kernels.distance1(x, y, count);
+    }
+
+    if(p == 2.) {
+        return w != nullptr ? kernels.weightedDistance2Squared(x, y, w, count) : kernels.distance2Squared(x, y, count);
+    }
+
+    return w != nullptr ? kernels.weightedDistanceInf(x, y, w, count) : kernels.distanceInf(x, y, count);
+}
+
+/* calls chunk(x, y, w, count) on consecutive chunks of the coordinates while it returns true; pOperand2 may be nullptr
+   for zeros, w is nullptr for an unweighted norm */
+template <class Chunk>
+void forChunks(INorm const * pNorm, IVector const * pOperand1, IVector const * pOperand2, Chunk const & chunk) {
+    size_t dim = pOperand1->getDim();
+    double const * weights = pNorm->getWeights();
+    double const * x = pOperand1->getData();
+    double const * y = pOperand2 == nullptr ? nullptr : pOperand2->getData();
+    double xBuffer[CHUNK], yBuffer[CHUNK];
+    bool next = true;
+
+    for(size_t begin = 0; begin < dim && next; begin += CHUNK) {
+        size_t count = std::min(CHUNK, dim - begin);
+        double const * xChunk = x != nullptr ? x + begin : chunkCoords(pOperand1, begin, count, xBuffer);
+        double const * yChunk = y != nullptr ? y + begin : chunkCoords(pOperand2, begin, count, yBuffer);
+
+        next = chunk(xChunk, yChunk, weights == nullptr ? nullptr : weights + begin, count);
+    }
+}
+
+/* largest * (sum of (|w_i (x_i - y_i)| / largest)^p)^(1/p) with the largest |w_i (x_i - y_i)|, so that no power
+   underflows or overflows; once the norm is known to exceed bound, a lower estimate above bound is returned */
+double scaledNorm(INorm const * pNorm, IVector const * pOperand1, IVector const * pOperand2, double bound) {
+    double p = pNorm->getP();
+    double largest = 0.;
+    double sum = 0.;
+
+    forChunks(pNorm, pOperand1, pOperand2, [&](double const * x, double const * y, double const * w, size_t count) {
+        double partial = chunkPowered(std::numeric_limits <double>::infinity(), x, y, w, count);
+
+        //NaN of infinite coordinates is kept
+        largest = partial <= largest ? largest : partial;
+
+        return largest <= bound;
+    });
+
+    if(largest == 0. || std::isinf(largest) || largest > bound) {
+        return largest;
+    }
+
+    //at least one, so that it does not underflow, and infinite when there is no bound
+    double limit = std::pow(bound / largest, p);
+
+    forChunks(pNorm, pOperand1, pOperand2, [&](double const * x, double const * y, double const * w, size_t count) {
+        for(size_t i = 0; i < count; ++i) {
+            sum += std::pow(std::fabs((x[i] - y[i]) * (w != nullptr ? w[i] : 1.)) / largest, p);
+        }
+
+        return sum <= limit;
+    });
+
+    return largest * std::pow(sum, 1. / p);
+}
+
+/* the norm of the difference, pOperand2 may be nullptr for the norm of pOperand1; once the norm is known to exceed
+   bound, a lower estimate above bound is returned */
+double normOf(INorm const * pNorm, IVector const * pOperand1, IVector const * pOperand2, double bound) {
+    double p = pNorm->getP();
+    double result = 0.;
+
+    if(p != 1. && p != 2. && !std::isinf(p)) {
+        return scaledNorm(pNorm, pOperand1, pOperand2, bound);
+    }
+
+    forChunks(pNorm, pOperand1, pOperand2, [&](double const * x, double const * y, double const * w, size_t count) {
+        double partial = chunkPowered(p, x, y, w, count);
+
+        result = std::isinf(p) ? std::max(result, partial) : result + partial;
+
+        return (p == 2. ? std::sqrt(result) : result) <= bound;
+    });
+
+    //squares that underflowed are below the rounding error of such a sum, otherwise the norm is scaled
+    if(p == 2. && !(result >= std::numeric_limits <double>::min() / std::numeric_limits <double>::epsilon() &&
+                    !std::isinf(result))) {
+        return scaledNorm(pNorm, pOperand1, pOperand2, bound);
+    }
+
+    return p == 2. ? std::sqrt(result) : result;
+}
+
+bool validArguments(IVector const * pOperand1, IVector const * pOperand2, INorm const * pNorm, char const * during,
+                    ILogger * pLogger) {
+    if(pOperand1 == nullptr || pOperand2 == nullptr || pNorm == nullptr) {
+        Loggable::printLogDuring("Operand or norm turned out to be equal to nullptr", during,
+                                 RESULT_CODE::BAD_REFERENCE, pLogger);
+
+        return false;
+    }
+
+    if(pOperand1->getDim() != pOperand2->getDim() || (pNorm->getDim() != 0 && pNorm->getDim() != pOperand1->getDim())) {
+        Loggable::printLogDuring("The dimensions of the vectors and the weighted norm are not equal", during,
+                                 RESULT_CODE::WRONG_DIM, pLogger);
+
+        return false;
+    }
+
+    return true;
+}
+
+RESULT_CODE errorCode(IVector const * pOperand1, IVector const * pOperand2, INorm const * pNorm) {
+    return pOperand1 == nullptr || pOperand2 == nullptr || pNorm == nullptr ? RESULT_CODE::BAD_REFERENCE :
+                                                                               RESULT_CODE::WRONG_DIM;
+}
+
+RESULT_CODE checkTolerance(double tolerance, char const * during, ILogger * pLogger) {
+    if(std::isnan(tolerance)) {
+        return Loggable::printLogDuring("Tolerance equal to NaN is passed", during, RESULT_CODE::NAN_VALUE, pLogger);
+    }
+
+    if(tolerance < 0) {
+        return Loggable::printLogDuring("Tolerance less than zero is passed", during, RESULT_CODE::WRONG_ARGUMENT,
+                                        pLogger);
+    }
+
+    return RESULT_CODE::SUCCESS;
+}
+}
+
+
+
+/* INorm */
+
+INorm::~INorm() = default;
+
+INorm * INorm::createNorm(double p, ILogger * pLogger) {
+    return Norm::createNorm(p, 0, nullptr, "INorm::createNorm", pLogger);
+}
+
+INorm * INorm::createWeightedNorm(double p, size_t dim, double const * pWeights, ILogger * pLogger) {
+    char const * during = "INorm::createWeightedNorm";
+
+    if(dim == 0) {
+        Loggable::printLogDuring("Trying to create a zero-dimensional weighted norm", during, RESULT_CODE::WRONG_DIM,
+                                 pLogger);
+
+        return nullptr;
+    }
+
+    if(pWeights == nullptr) {
+        Loggable::printLogDuring("Trying to create a norm with nullptr weights", during, RESULT_CODE::BAD_REFERENCE,
+                                 pLogger);
+
+        return nullptr;
+    }
+
+    return Norm::createNorm(p, dim, pWeights, during, pLogger);
+}
+
+
+
+/* IVector */
+
+double IVector::distance(IVector const * pOperand1, IVector const * pOperand2, INorm const * pNorm, ILogger * pLogger) {
+    char const * during = "IVector::distance";
+    NORM norm = NORM::NORM_2;
+
+    if(!validArguments(pOperand1, pOperand2, pNorm, during, pLogger)) {
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    if(standardNorm(pNorm, norm)) {
+        return IVector::distance(pOperand1, pOperand2, norm, pLogger);
+    }
+
+    return normOf(pNorm, pOperand1, pOperand2, std::numeric_limits <double>::infinity());
+}
+
+RESULT_CODE IVector::equals(IVector const * pOperand1, IVector const * pOperand2, INorm const * pNorm,
+                            double tolerance, bool * result, ILogger * pLogger) {
+    char const * during = "IVector::equals";
+
+    if(!validArguments(pOperand1, pOperand2, pNorm, during, pLogger)) {
+        return errorCode(pOperand1, pOperand2, pNorm);
+    }
+
+    RESULT_CODE code = checkTolerance(tolerance, during, pLogger);
+
+    if(code != RESULT_CODE::SUCCESS) {
+        return code;
+    }
+
+    double normDiff = IVector::distance(pOperand1, pOperand2, pNorm, pLogger);
+
+    if(std::isnan(normDiff)) {
+        return Loggable::printLogDuring("The norm of the difference between the operands turned out to be equal to NaN",
+                                        during, RESULT_CODE::NAN_VALUE, pLogger);
+    }
+
+    *result = normDiff <= tolerance;
+
+    return RESULT_CODE::SUCCESS;
+}
+
+RESULT_CODE IVector::withinTolerance(IVector const * pOperand1, IVector const * pOperand2, INorm const * pNorm,
+                                     double tolerance, bool * result, ILogger * pLogger) {
+    char const * during = "IVector::withinTolerance";
+    NORM norm = NORM::NORM_2;
+
+    if(!validArguments(pOperand1, pOperand2, pNorm, during, pLogger)) {
+        return errorCode(pOperand1, pOperand2, pNorm);
+    }
+
+    if(result == nullptr) {
+        return Loggable::printLogDuring("Result pointer turned out to be equal to nullptr", during,
+                                        RESULT_CODE::BAD_REFERENCE, pLogger);
+    }
+
+    if(standardNorm(pNorm, norm)) {
+        return IVector::withinTolerance(pOperand1, pOperand2, norm, tolerance, result, pLogger);
+    }
+
+    RESULT_CODE code = checkTolerance(tolerance, during, pLogger);
+
+    if(code != RESULT_CODE::SUCCESS) {
+        return code;
+    }
+
+    *result = normOf(pNorm, pOperand1, pOperand2, tolerance) <= tolerance;
+
+    return RESULT_CODE::SUCCESS;
+}
+
+
+
+/* Norm */
+
+Norm::Norm(double p, size_t dim, ILogger * pLogger) : INorm(), Loggable(pLogger), p(p), dim(dim), weights(nullptr) {}
+
+Norm::~Norm() {
+    delete [] weights;
+    weights = nullptr;
+}
+
+Norm * Norm::createNorm(double p, size_t dim, double const * pWeights, char const * during, ILogger * pLogger) {
+    if(std::isnan(p)) {
+        printLogDuring("Norm power equal to NaN is passed", during, RESULT_CODE::NAN_VALUE, pLogger);
+
+        return nullptr;
+    }
+
+    if(p < 1.) {
+        printLogDuring("Norm power less than one is passed", during, RESULT_CODE::WRONG_ARGUMENT, pLogger);
+
+        return nullptr;
+    }
+
+    for(size_t i = 0; pWeights != nullptr && i < dim; ++i) {
+        if(!(pWeights[i] >= 0.) || std::isinf(pWeights[i])) {
+            printLogDuring("Weights must be non-negative and finite", during,
+                           std::isnan(pWeights[i]) ? RESULT_CODE::NAN_VALUE : RESULT_CODE::WRONG_ARGUMENT, pLogger);
+
+            return nullptr;
+        }
+    }
+
+    Norm * norm = new (std::nothrow) Norm(p, pWeights == nullptr ? 0 : dim, pLogger);
+
+    if(norm != nullptr && pWeights != nullptr) {
+        norm->weights = new (std::nothrow) double[dim];
+
+        if(norm->weights != nullptr) {
+            memcpy(norm->weights, pWeights, dim * sizeof(double));
+        }
+    }
+
+    if(norm == nullptr || (pWeights != nullptr && norm->weights == nullptr)) {
+        printLogDuring("Not enough memory to create the norm", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+
+        delete norm;
+        norm = nullptr;
+    }
+
+    return norm;
+}
+
+INorm * Norm::clone() const {
+    return createNorm(p, dim, weights, "INorm::clone", logger);
+}
+
+double Norm::getP() const {
+    return p;
+}
+
+size_t Norm::getDim() const {
+    return dim;
+}
+
+double const * Norm::getWeights() const {
+    return weights;
+}
+
+double Norm::norm(IVector const * pVector) const {
+    char const * during = "INorm::norm";
+    IVector::NORM standard = IVector::NORM::NORM_2;
+
+    if(pVector == nullptr) {
+        printLogDuring("Vector turned out to be equal to nullptr", during, RESULT_CODE::BAD_REFERENCE, logger);
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    if(dim != 0 && pVector->getDim() != dim) {
+        printLogDuring("The dimensions of the vector and the weighted norm are not equal", during,
+                       RESULT_CODE::WRONG_DIM, logger);
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    //cached by the vectors that own their coordinates
+    if(standardNorm(this, standard)) {
+        return pVector->norm(standard);
+    }
+
+    return normOf(this, pVector, nullptr, std::numeric_limits <double>::infinity());
+}
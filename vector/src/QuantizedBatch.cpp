@@ -0,0 +1,467 @@
+#include <cmath>
+#include <mem.h>
+#include <limits>
+#include <algorithm>
+#include <new>
+#include <stdint.h>
+
+#include "../include/IQuantizedBatch.h"
+#include "Kernels.h"
+#include "Loggable.h"
+
+
+
+namespace {
+template <typename T>
+class QuantizedBatch : public IQuantizedBatch, private Loggable {
+public:
+    ~QuantizedBatch() override;
+    IQuantizedBatch * clone() const override;
+    size_t getCount() const override;
+    size_t getDim() const override;
+    CODE getCode() const override;
+    double getCoord(size_t index, size_t coord) const override;
+    double getScale(size_t index) const override;
+    double getOffset(size_t index) const override;
+    void const * getCodes() const override;
+    RESULT_CODE setVector(size_t index, IVector const * pVector) override;
+    IVector * createVector(size_t index) const override;
+    double getError(size_t index, IVector::NORM norm) const override;
+
+    static QuantizedBatch * createBatch(size_t count, size_t dim, ILogger * pLogger);
+
+private:
+    QuantizedBatch(size_t count, size_t dim, ILogger * pLogger);
+    QuantizedBatch(QuantizedBatch const & anotherBatch) = delete;
+    QuantizedBatch & operator = (QuantizedBatch const & anotherBatch) = delete;
+
+    //codes are kept symmetric around the offset, the minimum of T is not used
+    static T const MAX_CODE = std::numeric_limits <T>::max();
+
+    size_t count;
+    size_t dim;
+    T * codes;
+    double * scales;
+    double * offsets;
+    //norms 1, 2 and infinity of the rounding error, three per vector
+    double * errors;
+};
+
+/* tolerance of the filter to the rounding of the distances themselves */
+double const FILTER_SLACK = 1e-9;
+
+
+/* Secondary functions */
+
+bool validNorm(IVector::NORM norm, char const * during, ILogger * pLogger) {
+    if(norm != IVector::NORM::NORM_1 && norm != IVector::NORM::NORM_2 && norm != IVector::NORM::NORM_INF) {
+        Loggable::printLogDuring("Invalid value of norm", during, RESULT_CODE::WRONG_ARGUMENT, pLogger);
+
+        return false;
+    }
+
+    return true;
+}
+
+RESULT_CODE checkArguments(IQuantizedBatch const * pBatch, IVector const * pQuery, IVector::NORM norm,
+                           void const * pResults, char const * during, ILogger * pLogger) {
+    if(pBatch == nullptr || pQuery == nullptr || pResults == nullptr) {
+        return Loggable::printLogDuring("Batch, query or results turned out to be equal to nullptr", during,
+                                        RESULT_CODE::BAD_REFERENCE, pLogger);
+    }
+
+    if(pBatch->getDim() != pQuery->getDim()) {
+        return Loggable::printLogDuring("The dimensions of the batch and the query are not equal", during,
+                                        RESULT_CODE::WRONG_DIM, pLogger);
+    }
+
+    return validNorm(norm, during, pLogger) ? RESULT_CODE::SUCCESS : RESULT_CODE::WRONG_ARGUMENT;
+}
+
+double codeDistance(Kernels const & kernels, IVector::NORM norm, double const * query, int8_t const * codes,
+                    double scale, double offset, size_t dim) {
+    switch(norm) {
+    case IVector::NORM::NORM_1:
+        return kernels.codeDistance1Int8(query, codes, scale, offset, dim);
+
+    case IVector::NORM::NORM_2:
+        return std::sqrt(kernels.codeDistance2SquaredInt8(query, codes, scale, offset, dim));
+
+    default:
+        return kernels.codeDistanceInfInt8(query, codes, scale, offset, dim);
+    }
+}
+
+double codeDistance(Kernels const & kernels, IVector::NORM norm, double const * query, int16_t const * codes,
+                    double scale, double offset, size_t dim) {
+    switch(norm) {
+    case IVector::NORM::NORM_1:
+        return kernels.codeDistance1Int16(query, codes, scale, offset, dim);
+
+    case IVector::NORM::NORM_2:
+        return std::sqrt(kernels.codeDistance2SquaredInt16(query, codes, scale, offset, dim));
+
+    default:
+        return kernels.codeDistanceInfInt16(query, codes, scale, offset, dim);
+    }
+}
+
+template <typename T>
+void scanCodes(IQuantizedBatch const * pBatch, double const * query, IVector::NORM norm, double * pResults) {
+    Kernels const & kernels = Kernels::get();
+    size_t dim = pBatch->getDim();
+    T const * codes = (T const *) pBatch->getCodes();
+
+    for(size_t i = 0; i < pBatch->getCount(); ++i) {
+        pResults[i] = codeDistance(kernels, norm, query, codes + i * dim, pBatch->getScale(i), pBatch->getOffset(i),
+                                   dim);
+    }
+}
+
+/* distances to the decoded vectors, the query is copied only if it does not expose its coordinates */
+RESULT_CODE scan(IQuantizedBatch const * pBatch, IVector const * pQuery, IVector::NORM norm, double * pResults,
+                 char const * during, ILogger * pLogger) {
+    size_t dim = pBatch->getDim();
+    double const * query = pQuery->getData();
+    double * buffer = nullptr;
+
+    if(query == nullptr) {
+        buffer = new (std::nothrow) double[dim];
+
+        if(buffer == nullptr) {
+            return Loggable::printLogDuring("Not enough memory to copy the query", during, RESULT_CODE::OUT_OF_MEMORY,
+                                            pLogger);
+        }
+
+        for(size_t j = 0; j < dim; ++j) {
+            buffer[j] = pQuery->getCoord(j);
+        }
+
+        query = buffer;
+    }
+
+    if(pBatch->getCode() == IQuantizedBatch::CODE::INT8) {
+        scanCodes <int8_t> (pBatch, query, norm, pResults);
+    } else {
+        scanCodes <int16_t> (pBatch, query, norm, pResults);
+    }
+
+    delete [] buffer;
+    buffer = nullptr;
+
+    return RESULT_CODE::SUCCESS;
+}
+}
+
+
+
+/* IQuantizedBatch */
+
+IQuantizedBatch::~IQuantizedBatch() = default;
+
+IQuantizedBatch * IQuantizedBatch::createBatch(size_t count, size_t dim, CODE code, ILogger * pLogger) {
+    switch(code) {
+    case CODE::INT8:
+        return QuantizedBatch <int8_t>::createBatch(count, dim, pLogger);
+
+    case CODE::INT16:
+        return QuantizedBatch <int16_t>::createBatch(count, dim, pLogger);
+
+    default:
+        Loggable::printLogDuring("Invalid value of code", "IQuantizedBatch::createBatch", RESULT_CODE::WRONG_ARGUMENT,
+                                 pLogger);
+
+        return nullptr;
+    }
+}
+
+RESULT_CODE IQuantizedBatch::distance(IQuantizedBatch const * pBatch, IVector const * pQuery, IVector::NORM norm,
+                                      double * pResults, ILogger * pLogger) {
+    char const * during = "IQuantizedBatch::distance";
+    RESULT_CODE code = checkArguments(pBatch, pQuery, norm, pResults, during, pLogger);
+
+    if(code != RESULT_CODE::SUCCESS) {
+        return code;
+    }
+
+    return scan(pBatch, pQuery, norm, pResults, during, pLogger);
+}
+
+RESULT_CODE IQuantizedBatch::filter(IQuantizedBatch const * pBatch, IVector const * pQuery, IVector::NORM norm,
+                                    double tolerance, size_t * pIndices, size_t * pCount, ILogger * pLogger) {
+    char const * during = "IQuantizedBatch::filter";
+    RESULT_CODE code = checkArguments(pBatch, pQuery, norm, pIndices, during, pLogger);
+
+    if(code != RESULT_CODE::SUCCESS) {
+        return code;
+    }
+
+    if(pCount == nullptr) {
+        return Loggable::printLogDuring("Count pointer turned out to be equal to nullptr", during,
+                                        RESULT_CODE::BAD_REFERENCE, pLogger);
+    }
+
+    if(std::isnan(tolerance)) {
+        return Loggable::printLogDuring("Tolerance equal to NaN is passed", during, RESULT_CODE::NAN_VALUE, pLogger);
+    }
+
+    if(tolerance < 0) {
+        return Loggable::printLogDuring("Tolerance less than zero is passed", during, RESULT_CODE::WRONG_ARGUMENT,
+                                        pLogger);
+    }
+
+    size_t count = pBatch->getCount();
+    double * distances = new (std::nothrow) double[count];
+
+    if(distances == nullptr) {
+        return Loggable::printLogDuring("Not enough memory to filter the batch", during, RESULT_CODE::OUT_OF_MEMORY,
+                                        pLogger);
+    }
+
+    code = scan(pBatch, pQuery, norm, distances, during, pLogger);
+    *pCount = 0;
+
+    //by the triangle inequality the exact distance is at least the decoded one less the rounding error
+    for(size_t i = 0; i < count && code == RESULT_CODE::SUCCESS; ++i) {
+        double error = pBatch->getError(i, norm);
+
+        if(distances[i] - error <= tolerance + FILTER_SLACK * (distances[i] + error + tolerance)) {
+            pIndices[(*pCount)++] = i;
+        }
+    }
+
+    delete [] distances;
+    distances = nullptr;
+
+    return code;
+}
+
+
+
+/* QuantizedBatch */
+
+template <typename T>
+QuantizedBatch <T>::QuantizedBatch(size_t count, size_t dim, ILogger * pLogger) : IQuantizedBatch(), Loggable(pLogger),
+    count(count), dim(dim), codes(nullptr), scales(nullptr), offsets(nullptr), errors(nullptr) {}
+
+template <typename T>
+QuantizedBatch <T>::~QuantizedBatch() {
+    delete [] codes;
+    delete [] scales;
+    delete [] offsets;
+    delete [] errors;
+
+    codes = nullptr;
+    scales = nullptr;
+    offsets = nullptr;
+    errors = nullptr;
+}
+
+template <typename T>
+QuantizedBatch <T> * QuantizedBatch <T>::createBatch(size_t count, size_t dim, ILogger * pLogger) {
+    char const * during = "IQuantizedBatch::createBatch";
+
+    if(count == 0 || dim == 0) {
+        printLogDuring("Trying to create an empty batch or a batch of zero-dimensional vectors", during,
+                       RESULT_CODE::WRONG_DIM, pLogger);
+
+        return nullptr;
+    }
+
+    QuantizedBatch * batch = new (std::nothrow) QuantizedBatch(count, dim, pLogger);
+
+    if(batch != nullptr) {
+        batch->codes = new (std::nothrow) T[count * dim]();
+        batch->scales = new (std::nothrow) double[count]();
+        batch->offsets = new (std::nothrow) double[count]();
+        batch->errors = new (std::nothrow) double[3 * count]();
+    }
+
+    if(batch == nullptr || batch->codes == nullptr || batch->scales == nullptr || batch->offsets == nullptr ||
+       batch->errors == nullptr) {
+        printLogDuring("Not enough memory to create the batch", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+
+        delete batch;
+        batch = nullptr;
+    }
+
+    return batch;
+}
+
+template <typename T>
+IQuantizedBatch * QuantizedBatch <T>::clone() const {
+    QuantizedBatch * batch = createBatch(count, dim, logger);
+
+    if(batch != nullptr) {
+        memcpy(batch->codes, codes, count * dim * sizeof(T));
+        memcpy(batch->scales, scales, count * sizeof(double));
+        memcpy(batch->offsets, offsets, count * sizeof(double));
+        memcpy(batch->errors, errors, 3 * count * sizeof(double));
+    }
+
+    return batch;
+}
+
+template <typename T>
+size_t QuantizedBatch <T>::getCount() const {
+    return count;
+}
+
+template <typename T>
+size_t QuantizedBatch <T>::getDim() const {
+    return dim;
+}
+
+template <typename T>
+IQuantizedBatch::CODE QuantizedBatch <T>::getCode() const {
+    return sizeof(T) == 1 ? CODE::INT8 : CODE::INT16;
+}
+
+template <typename T>
+double QuantizedBatch <T>::getCoord(size_t index, size_t coord) const {
+    if(index >= count || coord >= dim) {
+        printLogDuring("Index of vector or coordinate out of bounds", "IQuantizedBatch::getCoord",
+                       RESULT_CODE::OUT_OF_BOUNDS, logger);
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    return offsets[index] + scales[index] * codes[index * dim + coord];
+}
+
+template <typename T>
+double QuantizedBatch <T>::getScale(size_t index) const {
+    if(index >= count) {
+        printLogDuring("Index of vector out of bounds", "IQuantizedBatch::getScale", RESULT_CODE::OUT_OF_BOUNDS,
+                       logger);
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    return scales[index];
+}
+
+template <typename T>
+double QuantizedBatch <T>::getOffset(size_t index) const {
+    if(index >= count) {
+        printLogDuring("Index of vector out of bounds", "IQuantizedBatch::getOffset", RESULT_CODE::OUT_OF_BOUNDS,
+                       logger);
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    return offsets[index];
+}
+
+template <typename T>
+void const * QuantizedBatch <T>::getCodes() const {
+    return codes;
+}
+
+template <typename T>
+RESULT_CODE QuantizedBatch <T>::setVector(size_t index, IVector const * pVector) {
+    char const * during = "IQuantizedBatch::setVector";
+
+    if(pVector == nullptr) {
+        return printLogDuring("Vector turned out to be equal to nullptr", during, RESULT_CODE::BAD_REFERENCE, logger);
+    }
+
+    if(index >= count) {
+        return printLogDuring("Index of vector out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+    }
+
+    if(pVector->getDim() != dim) {
+        return printLogDuring("The dimensions of the batch and the vector are not equal", during,
+                              RESULT_CODE::WRONG_DIM, logger);
+    }
+
+    double const * data = pVector->getData();
+    double min = std::numeric_limits <double>::infinity(), max = -min;
+
+    for(size_t j = 0; j < dim; ++j) {
+        double value = data != nullptr ? data[j] : pVector->getCoord(j);
+
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    double offset = min / 2. + max / 2.;
+    double scale = (max / 2. - min / 2.) / MAX_CODE;
+
+    if(!std::isfinite(offset) || !std::isfinite(scale)) {
+        return printLogDuring("Coordinates turned out to be out of the range of the codes", during,
+                              RESULT_CODE::CALCULATION_ERROR, logger);
+    }
+
+    T * vectorCodes = codes + index * dim;
+    double error1 = 0., error2 = 0., errorInf = 0.;
+
+    for(size_t j = 0; j < dim; ++j) {
+        double value = data != nullptr ? data[j] : pVector->getCoord(j);
+        double code = scale == 0. ? 0. : std::round((value - offset) / scale);
+
+        vectorCodes[j] = (T) std::max(-(double) MAX_CODE, std::min((double) MAX_CODE, code));
+
+        double error = std::fabs(value - (offset + scale * vectorCodes[j]));
+
+        error1 += error;
+        error2 += error * error;
+        errorInf = std::max(errorInf, error);
+    }
+
+    scales[index] = scale;
+    offsets[index] = offset;
+    errors[3 * index] = error1;
+    errors[3 * index + 1] = std::sqrt(error2);
+    errors[3 * index + 2] = errorInf;
+
+    return RESULT_CODE::SUCCESS;
+}
+
+template <typename T>
+IVector * QuantizedBatch <T>::createVector(size_t index) const {
+    char const * during = "IQuantizedBatch::createVector";
+
+    if(index >= count) {
+        printLogDuring("Index of vector out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+
+        return nullptr;
+    }
+
+    double * coords = new (std::nothrow) double[dim];
+
+    if(coords == nullptr) {
+        printLogDuring("Not enough memory to decode the vector", during, RESULT_CODE::OUT_OF_MEMORY, logger);
+
+        return nullptr;
+    }
+
+    for(size_t j = 0; j < dim; ++j) {
+        coords[j] = offsets[index] + scales[index] * codes[index * dim + j];
+    }
+
+    //finite scales and offsets decode to no NaN
+    IVector * vector = IVector::createTrustedVector(dim, coords, logger);
+
+    delete [] coords;
+    coords = nullptr;
+
+    return vector;
+}
+
+template <typename T>
+double QuantizedBatch <T>::getError(size_t index, IVector::NORM norm) const {
+    char const * during = "IQuantizedBatch::getError";
+
+    if(index >= count) {
+        printLogDuring("Index of vector out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    if(!validNorm(norm, during, logger)) {
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    return errors[3 * index + (norm == IVector::NORM::NORM_1 ? 0 : norm == IVector::NORM::NORM_2 ? 1 : 2)];
+}
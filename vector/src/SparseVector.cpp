@@ -0,0 +1,371 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <new>
+
+#include "SparseVector.h"
+#include "Kernels.h"
+
+
+
+namespace {
+/* Reads the coordinates of any vector in increasing index order, only the non-zero ones for sparse vectors */
+class Walker {
+public:
+    explicit Walker(IVector const * pVector) : vector(pVector), sparse(SparseVector::from(pVector)),
+        data(pVector == nullptr ? nullptr : pVector->getData()), position(0) {}
+
+    //the first index not less than index that may hold a non-zero coordinate, dim if there is none
+    size_t next(size_t index, size_t dim) {
+        if(vector == nullptr) {
+            return dim;
+        }
+
+        if(sparse == nullptr) {
+            return index;
+        }
+
+        skipTo(index);
+
+        return position < sparse->getCount() ? sparse->getIndices()[position] : dim;
+    }
+
+    //indices must not decrease from call to call
+    double at(size_t index) {
+        if(vector == nullptr) {
+            return 0.;
+        }
+
+        if(sparse == nullptr) {
+            return data != nullptr ? data[index] : vector->getCoord(index);
+        }
+
+        skipTo(index);
+
+        return position < sparse->getCount() && sparse->getIndices()[position] == index ?
+                    sparse->getValues()[position] : 0.;
+    }
+
+private:
+    void skipTo(size_t index) {
+        while(position < sparse->getCount() && sparse->getIndices()[position] < index) {
+            ++position;
+        }
+    }
+
+    IVector const * vector;
+    SparseVector const * sparse;
+    double const * data;
+    size_t position;
+};
+
+void accumulate(double & result, double diff, IVector::NORM norm) {
+    switch(norm) {
+    case IVector::NORM::NORM_1:
+        result += std::fabs(diff);
+        break;
+
+    case IVector::NORM::NORM_2:
+        result += diff * diff;
+        break;
+
+    case IVector::NORM::NORM_INF:
+        result = std::max(result, std::fabs(diff));
+        break;
+    }
+}
+}
+
+
+
+/* SparseVector */
+
+SparseVector::SparseVector(size_t dim, ILogger * pLogger) : IVector(), Loggable(pLogger), dim(dim) {}
+
+SparseVector::~SparseVector() = default;
+
+SparseVector * SparseVector::createVector(size_t dim, size_t count, size_t const * pIndices, double const * pValues,
+                                          ILogger * pLogger) {
+    char const * during = "IVector::createSparseVector";
+
+    if(dim == 0) {
+        printLogDuring("Trying to create a zero-dimensional vector", during, RESULT_CODE::WRONG_DIM, pLogger);
+
+        return nullptr;
+    }
+
+    if(count > 0 && (pIndices == nullptr || pValues == nullptr)) {
+        printLogDuring("Trying to create a vector with nullptr indices or values array", during,
+                       RESULT_CODE::BAD_REFERENCE, pLogger);
+
+        return nullptr;
+    }
+
+    for(size_t k = 0; k < count; ++k) {
+        if(pIndices[k] >= dim || (k > 0 && pIndices[k] <= pIndices[k - 1])) {
+            printLogDuring("Indices are out of bounds or not strictly increasing", during, RESULT_CODE::OUT_OF_BOUNDS,
+                           pLogger);
+
+            return nullptr;
+        }
+
+        if(std::isnan(pValues[k])) {
+            printLogDuring("NaN vector component was found", during, RESULT_CODE::NAN_VALUE, pLogger);
+
+            return nullptr;
+        }
+    }
+
+    SparseVector * vec = new (std::nothrow) SparseVector(dim, pLogger);
+
+    if(vec == nullptr) {
+        printLogDuring("Not enough memory to create the vector", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+
+        return nullptr;
+    }
+
+    try {
+        vec->indices.reserve(count);
+        vec->values.reserve(count);
+
+        for(size_t k = 0; k < count; ++k) {
+            //explicit zeros are not stored
+            if(pValues[k] != 0.) {
+                vec->indices.push_back(pIndices[k]);
+                vec->values.push_back(pValues[k]);
+            }
+        }
+    } catch(std::bad_alloc const &) {
+        printLogDuring("Not enough memory to create the vector", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+
+        delete vec;
+        vec = nullptr;
+    }
+
+    return vec;
+}
+
+SparseVector const * SparseVector::from(IVector const * pVector) {
+    return dynamic_cast <SparseVector const *> (pVector);
+}
+
+SparseVector * SparseVector::from(IVector * pVector) {
+    return dynamic_cast <SparseVector *> (pVector);
+}
+
+IVector * SparseVector::clone() const {
+    SparseVector * vec = new (std::nothrow) SparseVector(dim, logger);
+
+    if(vec == nullptr) {
+        printLogDuring("Not enough memory to create the vector", "IVector::clone", RESULT_CODE::OUT_OF_MEMORY, logger);
+
+        return nullptr;
+    }
+
+    try {
+        vec->indices = indices;
+        vec->values = values;
+    } catch(std::bad_alloc const &) {
+        printLogDuring("Not enough memory to create the vector", "IVector::clone", RESULT_CODE::OUT_OF_MEMORY, logger);
+
+        delete vec;
+        vec = nullptr;
+    }
+
+    return vec;
+}
+
+IVector * SparseVector::clone(IVectorArena *) const {
+    return clone();
+}
+
+double SparseVector::getCoord(size_t index) const {
+    char const * during = "IVector::getCoord";
+
+    if(index >= dim) {
+        printLogDuring("Index of vector in set out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    auto it = std::lower_bound(indices.begin(), indices.end(), index);
+
+    return it != indices.end() && *it == index ? values[it - indices.begin()] : 0.;
+}
+
+RESULT_CODE SparseVector::setCoord(size_t index, double value) {
+    char const * during = "IVector::setCoord";
+
+    if(index >= dim) {
+        return printLogDuring("Error in setting coord index", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+    }
+
+    if(std::isnan(value)) {
+        return printLogDuring("Coord value is equal to NaN", during, RESULT_CODE::NAN_VALUE, logger);
+    }
+
+    auto it = std::lower_bound(indices.begin(), indices.end(), index);
+    size_t position = it - indices.begin();
+    bool found = it != indices.end() && *it == index;
+
+    if(found && value == 0.) {
+        indices.erase(it);
+        values.erase(values.begin() + position);
+    } else if(found) {
+        values[position] = value;
+    } else if(value != 0.) {
+        //room in both arrays first, so that the inserts below do not allocate and the arrays stay the same length
+        try {
+            if(indices.size() == indices.capacity()) {
+                indices.reserve(2 * indices.size() + 1);
+            }
+
+            if(values.size() == values.capacity()) {
+                values.reserve(2 * values.size() + 1);
+            }
+        } catch(std::bad_alloc const &) {
+            return printLogDuring("Not enough memory to store the coordinate", during, RESULT_CODE::OUT_OF_MEMORY,
+                                  logger);
+        }
+
+        indices.insert(indices.begin() + position, index);
+        values.insert(values.begin() + position, value);
+    }
+
+    return RESULT_CODE::SUCCESS;
+}
+
+double SparseVector::norm(NORM norm) const {
+    char const * during = "IVector::norm";
+    Kernels const & kernels = Kernels::get();
+
+    switch(norm) {
+    case NORM::NORM_1:
+        return kernels.norm1(values.data(), values.size());
+
+    case NORM::NORM_2:
+        return std::sqrt(kernels.norm2Squared(values.data(), values.size()));
+
+    case NORM::NORM_INF:
+        return kernels.normInf(values.data(), values.size());
+    }
+
+    printLogDuring("Invalid value of norm", during, RESULT_CODE::WRONG_ARGUMENT, logger);
+
+    return std::numeric_limits <double>::quiet_NaN();
+}
+
+size_t SparseVector::getDim() const {
+    return dim;
+}
+
+//coordinates are not stored as one array
+double const * SparseVector::getData() const {
+    return nullptr;
+}
+
+double * SparseVector::getMutableData() {
+    return nullptr;
+}
+
+size_t SparseVector::getCount() const {
+    return indices.size();
+}
+
+size_t const * SparseVector::getIndices() const {
+    return indices.data();
+}
+
+double const * SparseVector::getValues() const {
+    return values.data();
+}
+
+double SparseVector::dot(IVector const * pOperand1, IVector const * pOperand2) {
+    SparseVector const * sparse = from(pOperand1);
+    IVector const * other = pOperand2;
+
+    if(sparse == nullptr) {
+        sparse = from(pOperand2);
+        other = pOperand1;
+    }
+
+    //only the non-zero coordinates of the sparse operand matter
+    Walker walker(other);
+    double result = 0.;
+
+    for(size_t k = 0; k < sparse->getCount(); ++k) {
+        result += sparse->values[k] * walker.at(sparse->indices[k]);
+    }
+
+    return result;
+}
+
+double SparseVector::distance(IVector const * pOperand1, IVector const * pOperand2, NORM norm) {
+    size_t dim = pOperand1->getDim();
+    Walker walker1(pOperand1), walker2(pOperand2);
+    double result = 0.;
+
+    for(size_t i = std::min(walker1.next(0, dim), walker2.next(0, dim)); i < dim;
+        i = std::min(walker1.next(i + 1, dim), walker2.next(i + 1, dim))) {
+        accumulate(result, walker1.at(i) - walker2.at(i), norm);
+    }
+
+    return norm == NORM::NORM_2 ? std::sqrt(result) : result;
+}
+
+bool SparseVector::within(IVector const * pOperand1, IVector const * pOperand2, NORM norm, double tolerance) {
+    size_t dim = pOperand1->getDim();
+    Walker walker1(pOperand1), walker2(pOperand2);
+    double bound = norm == NORM::NORM_2 ? tolerance * tolerance : tolerance;
+    double result = 0.;
+
+    for(size_t i = std::min(walker1.next(0, dim), walker2.next(0, dim)); i < dim;
+        i = std::min(walker1.next(i + 1, dim), walker2.next(i + 1, dim))) {
+        accumulate(result, walker1.at(i) - walker2.at(i), norm);
+
+        if(!(result <= bound)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+RESULT_CODE SparseVector::assign(double alpha, IVector const * pX, double beta, IVector const * pY) {
+    Walker walkerX(pX), walkerY(pY);
+    std::vector <size_t> newIndices;
+    std::vector <double> newValues;
+
+    try {
+        for(size_t i = std::min(walkerX.next(0, dim), walkerY.next(0, dim)); i < dim;
+            i = std::min(walkerX.next(i + 1, dim), walkerY.next(i + 1, dim))) {
+            double value = alpha * walkerX.at(i) + beta * walkerY.at(i);
+
+            if(std::isnan(value)) {
+                return RESULT_CODE::CALCULATION_ERROR;
+            }
+
+            if(value != 0.) {
+                newIndices.push_back(i);
+                newValues.push_back(value);
+            }
+        }
+    } catch(std::bad_alloc const &) {
+        return RESULT_CODE::OUT_OF_MEMORY;
+    }
+
+    //the operands may be this vector, so it is replaced only now
+    indices.swap(newIndices);
+    values.swap(newValues);
+
+    return RESULT_CODE::SUCCESS;
+}
+
+void SparseVector::assign(double * pResult, size_t dim, double alpha, IVector const * pX, double beta,
+                          IVector const * pY) {
+    Walker walkerX(pX), walkerY(pY);
+
+    for(size_t i = 0; i < dim; ++i) {
+        pResult[i] = alpha * walkerX.at(i) + beta * walkerY.at(i);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef SPARSEVECTOR_H
+#define SPARSEVECTOR_H
+
+#include <vector>
+
+#include "../include/IVector.h"
+#include "Loggable.h"
+
+
+
+/* Non-zero coordinates only, as index/value pairs sorted by index */
+class SparseVector : public IVector, private Loggable {
+public:
+    ~SparseVector() override;
+    //sparse vectors grow while coordinates are set, so clones always take their memory from the heap
+    IVector * clone() const override;
+    IVector * clone(IVectorArena * pArena) const override;
+    double getCoord(size_t index) const override;
+    RESULT_CODE setCoord(size_t index, double value) override;
+    double norm(NORM norm) const override;
+    size_t getDim() const override;
+    double const * getData() const override;
+    double * getMutableData() override;
+
+    size_t getCount() const;
+    size_t const * getIndices() const;
+    double const * getValues() const;
+
+    static SparseVector * createVector(size_t dim, size_t count, size_t const * pIndices, double const * pValues,
+                                       ILogger * pLogger);
+    //nullptr if the vector is not sparse
+    static SparseVector const * from(IVector const * pVector);
+    static SparseVector * from(IVector * pVector);
+
+    /* Fast paths of the static IVector functions, one operand at least is sparse and dimensions are equal */
+    static double dot(IVector const * pOperand1, IVector const * pOperand2);
+    static double distance(IVector const * pOperand1, IVector const * pOperand2, NORM norm);
+    static bool within(IVector const * pOperand1, IVector const * pOperand2, NORM norm, double tolerance);
+    //this = alpha * pX + beta * pY, pY may be nullptr and both may alias this; unchanged on CALCULATION_ERROR for NaN
+    //and on OUT_OF_MEMORY
+    RESULT_CODE assign(double alpha, IVector const * pX, double beta, IVector const * pY);
+    //the same into dense coordinates, which may be those of the operands; the caller checks the result for NaN first
+    static void assign(double * pResult, size_t dim, double alpha, IVector const * pX, double beta, IVector const * pY);
+
+private:
+    SparseVector(size_t dim, ILogger * pLogger);
+    SparseVector(SparseVector const & anotherVector) = delete;
+    SparseVector & operator = (SparseVector const & anotherVector) = delete;
+
+    size_t dim;
+    std::vector <size_t> indices;
+    std::vector <double> values;
+};
+
+#endif // SPARSEVECTOR_H
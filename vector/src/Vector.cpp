@@ -2,101 +2,127 @@
 #include <cmath>
 #include <mem.h>
 #include <limits>
+#include <algorithm>
+#include <new>
+#include <cassert>
+#include <atomic>
+#include <vector>
 
 #include "../include/IVector.h"
+#include "../include/IVectorArena.h"
+#include "Kernels.h"
+#include "Loggable.h"
+#include "SparseVector.h"
+#include "WorkerPool.h"
 
 
 
 namespace {
-class Loggable {
-public:
-    explicit Loggable(ILogger * pLogger);
-    virtual ~Loggable() = 0;
-    static RESULT_CODE printLog(char const * pMsg, RESULT_CODE err, ILogger * pLogger);
-    static RESULT_CODE printLogDuring(char const * pMsg, char const * during, RESULT_CODE err, ILogger * pLogger);
-
-    static char const ErrorName[][30];
-    ILogger * logger;
-
-private:
-    Loggable() = delete;
-
-    static RESULT_CODE printFormatted(FILE * logStream, char const * pMsg, RESULT_CODE err);
+/* Start of every block a vector is allocated in */
+struct BlockHeader {
+    //nullptr for the heap
+    IVectorArena * arena;
+    //heap blocks only: one for the vector living in the block until it is deleted,
+    //and one per clone sharing its coordinates
+    std::atomic <size_t> refs;
 };
 
-
-
+/* Coordinates are stored as T, every calculation is carried out in double precision */
+template <typename T>
 class Vector : public IVector, private Loggable {
 public:
     ~Vector() override;
     IVector * clone() const override;
+    IVector * clone(IVectorArena * pArena) const override;
     double getCoord(size_t index) const override;
     RESULT_CODE setCoord(size_t index, double value) override;
     double norm(NORM norm) const override;
     size_t getDim() const override;
+    double const * getData() const override;
+    double * getMutableData() override;
+
+    T const * getCoords() const;
+    T * getMutableCoords();
+    //a norm computed while the coordinates were written, kept by vectors longer than a cache line
+    void cacheNorm(NORM norm, double value) const;
+    //clone with coordinates of its own, for results that are written right away
+    Vector * copy(IVectorArena * pArena) const;
 
-    static Vector * createVector(size_t dim, double * pData, ILogger * pLogger);
+    //trusted coordinates are checked for NaN in debug builds only
+    static Vector * createVector(size_t dim, T const * pData, ILogger * pLogger, IVectorArena * pArena, bool trusted);
+
+    //ownCoords is false for a clone sharing the coordinates of another block
+    static void * operator new(size_t size, size_t dim, IVectorArena * pArena, bool ownCoords) noexcept;
+    static void operator delete(void * pointer);
 
 private:
     Vector() = delete;
     Vector(Vector const & anotherVector) = delete;
     Vector & operator = (Vector const & anotherVector) = delete;
-    Vector(size_t dim, double * pData, ILogger * pLogger);
+    Vector(size_t dim, ILogger * pLogger);
+    //a clone reading the coordinates of another block until it is written
+    Vector(size_t dim, T * sharedCoords, BlockHeader * sharedBlock, ILogger * pLogger);
+
+    /* State of vectors longer than INLINE_DIM, kept right after the object; shorter vectors have nothing but their
+       coordinates there, which are cheaper to copy and to sum again than to share and to cache */
+    struct Extension {
+        T * coords;
+        //the block holding coords
+        BlockHeader * block;
+        //by NORM, NaN until computed; coordinates never contain NaN, so norms never are
+        std::atomic <double> norms[3];
+        //set once getMutableData handed the coordinates out, they may be written at any time after that
+        std::atomic <bool> exposed;
+    };
+
+    static Vector * allocate(size_t dim, ILogger * pLogger, IVectorArena * pArena);
+    static size_t extensionSize(size_t dim);
+    static T * trailingCoords(void * pointer, size_t dim);
+    static BlockHeader * header(void const * pointer);
+    static void release(BlockHeader * block);
+    Extension * extension() const;
+    T * coords() const;
+    void invalidateNorms();
+    //copies shared coordinates before the first write, false if there is no memory for them
+    bool detach();
+
+    //coordinates follow the object in the same block, packed right after it up to this dimension
+    static size_t const INLINE_DIM = 64 / sizeof(T);
+    //and aligned to a cache line for larger vectors
+    static size_t const ALIGNMENT = 64;
+    //every block starts with the arena it came from, nullptr for the heap
+    static size_t const HEADER_SIZE = 16;
+    static_assert(sizeof(BlockHeader) <= HEADER_SIZE, "Block header does not fit");
 
     size_t dim;
-    double * coords;
 };
-}
-
-
-
-/* Loggable */
-
-Loggable::Loggable(ILogger * pLogger) : logger(pLogger) {}
-
-Loggable::~Loggable() = default;
 
-RESULT_CODE Loggable::printFormatted(FILE * logStream, char const * pMsg, RESULT_CODE err) {
-    fprintf(logStream, "%s: %s\n", ErrorName[(int) err], pMsg);
-
-    return err;
-}
-
-RESULT_CODE Loggable::printLog(char const * pMsg, RESULT_CODE err, ILogger * pLogger) {
-    if(pLogger != nullptr) {
-        pLogger->log(pMsg, err);
-    } else {
-        printFormatted(stderr, pMsg, err);
-    }
-
-    return err;
-}
-
-RESULT_CODE Loggable::printLogDuring(char const * pMsg, char const * during, RESULT_CODE err, ILogger * pLogger) {
-    char result[1024] = "";
+/* Borrows coordinates of an external buffer, which must outlive the view and must not contain NaN */
+class VectorView : public IVector, private Loggable {
+public:
+    VectorView(size_t dim, double * pData, bool readOnly, ILogger * pLogger);
+    ~VectorView() override;
+    IVector * clone() const override;
+    IVector * clone(IVectorArena * pArena) const override;
+    double getCoord(size_t index) const override;
+    RESULT_CODE setCoord(size_t index, double value) override;
+    double norm(NORM norm) const override;
+    size_t getDim() const override;
+    double const * getData() const override;
+    double * getMutableData() override;
 
-    strcat(result, pMsg);
-    strcat(result, " during \"");
-    strcat(result, during);
-    strcat(result, "\"");
+    static VectorView * createView(size_t dim, double * pData, bool readOnly, ILogger * pLogger);
 
-    return printLog(result, err, pLogger);
-}
+private:
+    VectorView() = delete;
+    VectorView(VectorView const & anotherView) = delete;
+    VectorView & operator = (VectorView const & anotherView) = delete;
 
-char const Loggable::ErrorName[][30] = {
-    "SUCCESS",
-    "OUT_OF_MEMORY",
-    "BAD_REFERENCE",
-    "WRONG_DIM",
-    "DIVISION_BY_ZERO",
-    "NAN_VALUE",
-    "FILE_ERROR",
-    "OUT_OF_BOUNDS",
-    "NOT_FOUND",
-    "WRONG_ARGUMENT",
-    "CALCULATION_ERROR",
-    "MULTIPLE_DEFINITION"
+    size_t dim;
+    double * coords;
+    bool readOnly;
 };
+}
 
 
 
@@ -135,304 +161,1585 @@ bool equalDims(IVector const * pOperand1, IVector const * pOperand2, char const
     return true;
 }
 
+/* interned vectors and clones that were not written share coordinates, so they are equal without reading them */
+bool sharedCoords(IVector const * pOperand1, IVector const * pOperand2, IVector::NORM norm) {
+    double const * x = pOperand1->getData();
+    bool validNorm = norm == IVector::NORM::NORM_1 || norm == IVector::NORM::NORM_2 || norm == IVector::NORM::NORM_INF;
 
+    return validNorm && (pOperand1 == pOperand2 || (x != nullptr && x == pOperand2->getData()));
+}
 
-/* IVector */
+bool resultHasDim(IVector const * pResult, size_t dim, char const * during, ILogger * pLogger) {
+    if(pResult == nullptr) {
+        Loggable::printLogDuring("Result vector turned out to be equal to nullptr", during, RESULT_CODE::BAD_REFERENCE,
+                                 pLogger);
 
-IVector::~IVector() = default;
+        return false;
+    }
 
-IVector * IVector::createVector(size_t dim, double * pData, ILogger * pLogger) {
-    return Vector::createVector(dim, pData, pLogger);
+    if(pResult->getDim() != dim) {
+        Loggable::printLogDuring("The dimension of the result vector is not equal to the operands one", during,
+                                 RESULT_CODE::WRONG_DIM, pLogger);
+
+        return false;
+    }
+
+    return true;
 }
 
-IVector * IVector::add(IVector const * pOperand1, IVector const * pOperand2, ILogger * pLogger) {
-    char const * during = "IVector::add";
+double * doubleCoords(double * coords) {
+    return coords;
+}
 
-    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger) || !equalDims(pOperand1, pOperand2, during, pLogger)) {
-        return nullptr;
+//single precision coordinates are not exposed as doubles
+double * doubleCoords(float *) {
+    return nullptr;
+}
+
+/* float-backed vectors of this library, nullptr for anything else */
+float const * floatCoords(IVector const * pVector) {
+    Vector <float> const * vec = dynamic_cast <Vector <float> const *> (pVector);
+
+    return vec == nullptr ? nullptr : vec->getCoords();
+}
+
+float * mutableFloatCoords(IVector * pVector) {
+    Vector <float> * vec = dynamic_cast <Vector <float> *> (pVector);
+
+    return vec == nullptr ? nullptr : vec->getMutableCoords();
+}
+
+/* coordinates written right away by a kernel, which does not expose them the way getMutableData does */
+double * mutableDoubleCoords(IVector * pVector) {
+    Vector <double> * vec = dynamic_cast <Vector <double> *> (pVector);
+
+    return vec == nullptr ? pVector->getMutableData() : vec->getMutableCoords();
+}
+
+//coordinates per parallel task, fixed so that the partial results do not depend on the threads count
+size_t const PARALLEL_CHUNK = 1 << 15;
+std::atomic <size_t> parallelThreshold(1 << 18);
+
+/* partial(begin, size) over chunks of PARALLEL_CHUNK coordinates split between threads and combined in their order
+   by sum or by maximum; below the threshold it is called once for all the coordinates */
+template <typename Partial>
+double reduceChunks(size_t dim, bool maximum, Partial const & partial) {
+    if(dim < parallelThreshold.load(std::memory_order_relaxed)) {
+        return partial(0, dim);
     }
 
-    IVector * result = pOperand1->clone();
+    size_t chunks = (dim + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+    std::vector <double> partials;
 
-    if(result == nullptr) {
-        Loggable::printLogDuring("Failed to clone first operand", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+    try {
+        partials.resize(chunks);
+        WorkerPool::get().run(chunks, [&](size_t chunk) {
+            size_t begin = chunk * PARALLEL_CHUNK;
 
-        return nullptr;
+            partials[chunk] = partial(begin, std::min(PARALLEL_CHUNK, dim - begin));
+        });
+    } catch(std::bad_alloc const &) {
+        //the same chunks one after another
+        partials.clear();
     }
 
-    for(size_t i = 0; i < pOperand1->getDim(); ++i) {
-        if(result->setCoord(i, pOperand1->getCoord(i) + pOperand2->getCoord(i)) != RESULT_CODE::SUCCESS) {
-            Loggable::printLogDuring("Failed to add coordinates", during, RESULT_CODE::CALCULATION_ERROR, pLogger);
+    double result = 0.;
 
-            delete result;
-            result = nullptr;
+    for(size_t chunk = 0; chunk < chunks; ++chunk) {
+        size_t begin = chunk * PARALLEL_CHUNK;
+        double value = partials.empty() ? partial(begin, std::min(PARALLEL_CHUNK, dim - begin)) : partials[chunk];
 
-            return nullptr;
+        if(!maximum) {
+            result += value;
+        } else if(!std::isnan(result) && !(value <= result)) {
+            result = value;
         }
     }
 
     return result;
 }
 
-IVector * IVector::sub(IVector const * pOperand1, IVector const * pOperand2, ILogger * pLogger) {
-    char const * during = "IVector::sub";
+/* returns the largest absolute value written */
+template <typename T>
+double combineCoords(T * result, double alpha, T const * x, double beta, T const * y, size_t dim) {
+    double largest = 0.;
 
-    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger) || !equalDims(pOperand1, pOperand2, during, pLogger)) {
-        return nullptr;
+    if(y == nullptr) {
+        for(size_t i = 0; i < dim; ++i) {
+            result[i] = (T) (alpha * x[i]);
+            largest = std::max(largest, (double) std::fabs(result[i]));
+        }
+    } else {
+        for(size_t i = 0; i < dim; ++i) {
+            result[i] = (T) (alpha * x[i] + beta * y[i]);
+            largest = std::max(largest, (double) std::fabs(result[i]));
+        }
     }
 
-    IVector * pOperand2Inversed = IVector::mul(pOperand2, -1, pLogger);
+    return largest;
+}
 
-    if(pOperand2Inversed == nullptr) {
-        Loggable::printLogDuring("Failed to multiply first operand by -1", during, RESULT_CODE::CALCULATION_ERROR,
-                                 pLogger);
+template <typename T>
+double combineChunks(T * result, double alpha, T const * x, double beta, T const * y, size_t dim) {
+    return reduceChunks(dim, true, [&](size_t begin, size_t size) {
+        return combineCoords(result + begin, alpha, x + begin, beta, y == nullptr ? nullptr : y + begin, size);
+    });
+}
 
-        return nullptr;
+/* the maximum norm of a result found while writing it, so that the check of the next combination over it does not
+   read the coordinates again */
+void cacheNormInf(IVector const * pResult, double value) {
+    Vector <double> const * dense = dynamic_cast <Vector <double> const *> (pResult);
+    Vector <float> const * single = dense == nullptr ? dynamic_cast <Vector <float> const *> (pResult) : nullptr;
+
+    if(dense != nullptr) {
+        dense->cacheNorm(IVector::NORM::NORM_INF, value);
+    } else if(single != nullptr) {
+        single->cacheNorm(IVector::NORM::NORM_INF, value);
     }
+}
 
-    IVector * result = IVector::add(pOperand1, pOperand2Inversed, pLogger);
+/* true if a NaN coordinate would be obtained, nothing is written */
+template <typename T>
+bool combinationHasNaN(double alpha, T const * x, double beta, T const * y, size_t dim) {
+    return reduceChunks(dim, true, [&](size_t begin, size_t size) {
+        bool nanFound = false;
 
-    delete pOperand2Inversed;
-    pOperand2Inversed = nullptr;
+        for(size_t i = begin; i < begin + size; ++i) {
+            nanFound |= std::isnan(y == nullptr ? alpha * x[i] : alpha * x[i] + beta * y[i]);
+        }
 
-    if(result == nullptr) {
-        Loggable::printLogDuring("Failed to add vectors", during, RESULT_CODE::CALCULATION_ERROR, pLogger);
+        return nanFound ? 1. : 0.;
+    }) > 0.;
+}
 
-        return nullptr;
+/* the same for any vectors; the coordinates are only read when the maximum norms do not bound the result, and the
+   norms themselves are cached by long vectors, including the results of combinations */
+bool combinationHasNaN(double alpha, IVector const * pX, double beta, IVector const * pY) {
+    double bound = std::fabs(alpha) * pX->norm(IVector::NORM::NORM_INF);
+
+    if(pY != nullptr) {
+        bound += std::fabs(beta) * pY->norm(IVector::NORM::NORM_INF);
     }
 
-    return result;
-}
+    if(std::isfinite(bound)) {
+        return false;
+    }
 
-IVector * IVector::mul(IVector const * pOperand1, double scaleParam, ILogger * pLogger) {
-    char const * during = "IVector::mul";
+    size_t dim = pX->getDim();
+    double const * x = pX->getData();
+    double const * y = pY == nullptr ? nullptr : pY->getData();
+    float const * xFloat = x == nullptr ? floatCoords(pX) : nullptr;
+    float const * yFloat = xFloat == nullptr || pY == nullptr ? nullptr : floatCoords(pY);
 
-    if(pOperand1 == nullptr) {
-        Loggable::printLogDuring("First operand (vector) turned out to be equal to nullptr", during,
-                                 RESULT_CODE::BAD_REFERENCE, pLogger);
+    if(x != nullptr && (pY == nullptr || y != nullptr)) {
+        return combinationHasNaN(alpha, x, beta, y, dim);
+    }
 
-        return nullptr;
+    if(xFloat != nullptr && (pY == nullptr || yFloat != nullptr)) {
+        return combinationHasNaN(alpha, xFloat, beta, yFloat, dim);
     }
 
-    if(std::isnan(scaleParam)) {
-        Loggable::printLogDuring("Second operand (scalar) turned out to be equal to NaN", during,
-                                 RESULT_CODE::NAN_VALUE, pLogger);
+    for(size_t i = 0; i < dim; ++i) {
+        double value = alpha * pX->getCoord(i);
 
-        return nullptr;
+        if(pY != nullptr) {
+            value += beta * pY->getCoord(i);
+        }
+
+        if(std::isnan(value)) {
+            return true;
+        }
     }
 
-    IVector * result = pOperand1->clone();
+    return false;
+}
 
-    if(result == nullptr) {
-        Loggable::printLogDuring("Failed to clone first operand (vector)", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+/* pResult = alpha * pX + beta * pY in one pass, pY may be nullptr; pResult may alias the operands
+   and is left unchanged if a NaN coordinate would be obtained */
+RESULT_CODE linearCombination(IVector * pResult, double alpha, IVector const * pX, double beta, IVector const * pY,
+                              char const * during, ILogger * pLogger) {
+    if(combinationHasNaN(alpha, pX, beta, pY)) {
+        return Loggable::printLogDuring("NaN coordinate would be obtained, the result vector is left unchanged", during,
+                                        RESULT_CODE::CALCULATION_ERROR, pLogger);
+    }
 
-        return nullptr;
+    size_t dim = pResult->getDim();
+    double * result = mutableDoubleCoords(pResult);
+    double const * x = pX->getData();
+    double const * y = pY == nullptr ? nullptr : pY->getData();
+    float * resultFloat = result == nullptr ? mutableFloatCoords(pResult) : nullptr;
+    float const * xFloat = resultFloat == nullptr ? nullptr : floatCoords(pX);
+    float const * yFloat = xFloat == nullptr || pY == nullptr ? nullptr : floatCoords(pY);
+
+    if(result != nullptr && x != nullptr && (pY == nullptr || y != nullptr)) {
+        cacheNormInf(pResult, combineChunks(result, alpha, x, beta, y, dim));
+
+        return RESULT_CODE::SUCCESS;
     }
 
-    for(size_t i = 0; i < pOperand1->getDim(); ++i) {
-        if(result->setCoord(i, pOperand1->getCoord(i) * scaleParam) != RESULT_CODE::SUCCESS) {
-            Loggable::printLogDuring("Failed to multiply coordinate", during, RESULT_CODE::CALCULATION_ERROR, pLogger);
+    SparseVector * resultSparse = SparseVector::from(pResult);
+    bool sparseOperand = SparseVector::from(pX) != nullptr || SparseVector::from(pY) != nullptr;
 
-            delete result;
-            result = nullptr;
+    if(resultSparse != nullptr) {
+        RESULT_CODE code = resultSparse->assign(alpha, pX, beta, pY);
 
-            return nullptr;
+        if(code != RESULT_CODE::SUCCESS) {
+            return Loggable::printLogDuring(code == RESULT_CODE::OUT_OF_MEMORY ? "Not enough memory for the result" :
+                                            "NaN coordinate was obtained", during, code, pLogger);
         }
+
+        return RESULT_CODE::SUCCESS;
     }
 
-    return result;
-}
+    if(result != nullptr && sparseOperand) {
+        SparseVector::assign(result, dim, alpha, pX, beta, pY);
 
-double IVector::mul(IVector const * pOperand1, IVector const * pOperand2, ILogger * pLogger) {
-    char const * during = "IVector::mul";
+        return RESULT_CODE::SUCCESS;
+    }
 
-    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger) || !equalDims(pOperand1, pOperand2, during, pLogger)) {
-        return std::numeric_limits <double>::quiet_NaN();
+    if(resultFloat != nullptr && xFloat != nullptr && (pY == nullptr || yFloat != nullptr)) {
+        cacheNormInf(pResult, combineChunks(resultFloat, alpha, xFloat, beta, yFloat, dim));
+
+        return RESULT_CODE::SUCCESS;
     }
 
-    double result = 0.;
+    for(size_t i = 0; i < dim; ++i) {
+        double value = alpha * pX->getCoord(i);
 
-    for(size_t i = 0; i < pOperand1->getDim(); ++i) {
-        result += pOperand1->getCoord(i) * pOperand2->getCoord(i);
+        if(pY != nullptr) {
+            value += beta * pY->getCoord(i);
+        }
+
+        if(pResult->setCoord(i, value) != RESULT_CODE::SUCCESS) {
+            return Loggable::printLogDuring("Failed to set coordinate", during, RESULT_CODE::CALCULATION_ERROR,
+                                            pLogger);
+        }
     }
 
-    return result;
+    return RESULT_CODE::SUCCESS;
 }
 
-RESULT_CODE IVector::equals(IVector const * pOperand1, IVector const * pOperand2, NORM norm, double tolerance,
-                            bool * result, ILogger * pLogger) {
-    char const * during = "IVector::equals";
 
-    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger)) {
-        return RESULT_CODE::BAD_REFERENCE;
-    }
+/* results of the allocating operations are written at once, so sharing coordinates would only add a copy */
+IVector * writableClone(IVector const * pVector) {
+    Vector <double> const * dense = dynamic_cast <Vector <double> const *> (pVector);
 
-    if(!equalDims(pOperand1, pOperand2, during, pLogger)) {
-        return RESULT_CODE::WRONG_DIM;
+    if(dense != nullptr) {
+        return dense->copy(nullptr);
     }
 
-    if(std::isnan(tolerance)) {
-        return Loggable::printLogDuring("Tolerance equal to NaN is passed", during, RESULT_CODE::NAN_VALUE, pLogger);
-    }
+    Vector <float> const * single = dynamic_cast <Vector <float> const *> (pVector);
 
-    if(tolerance < 0) {
-        return Loggable::printLogDuring("Tolerance less than zero is passed", during, RESULT_CODE::WRONG_ARGUMENT,
-                                        pLogger);
-    }
+    return single != nullptr ? single->copy(nullptr) : pVector->clone();
+}
 
-    IVector * diff = IVector::sub(pOperand1, pOperand2, pLogger);
 
-    if(diff == nullptr) {
-        return Loggable::printLogDuring("The difference between the operands turned out to be equal to nullptr", during,
-                                        RESULT_CODE::CALCULATION_ERROR, pLogger);
-    }
+/* Kernels table entries by storage type */
 
-    double normDiff = diff->norm(norm);
+double norm1Of(Kernels const & kernels, double const * x, size_t dim) {
+    return kernels.norm1(x, dim);
+}
 
-    delete diff;
-    diff = nullptr;
+double norm1Of(Kernels const & kernels, float const * x, size_t dim) {
+    return kernels.norm1Float(x, dim);
+}
 
-    if(std::isnan(normDiff)) {
-        return Loggable::printLogDuring("The norm of the difference between the operands turned out to be equal to NaN",
-                                        during, RESULT_CODE::NAN_VALUE, pLogger);
-    }
+double norm2SquaredOf(Kernels const & kernels, double const * x, size_t dim) {
+    return kernels.norm2Squared(x, dim);
+}
 
-    *result = normDiff <= tolerance;
+double norm2SquaredOf(Kernels const & kernels, float const * x, size_t dim) {
+    return kernels.norm2SquaredFloat(x, dim);
+}
 
-    return RESULT_CODE::SUCCESS;
+double normInfOf(Kernels const & kernels, double const * x, size_t dim) {
+    return kernels.normInf(x, dim);
 }
 
+double normInfOf(Kernels const & kernels, float const * x, size_t dim) {
+    return kernels.normInfFloat(x, dim);
+}
 
+double dotOf(Kernels const & kernels, double const * x, double const * y, size_t dim) {
+    return kernels.dot(x, y, dim);
+}
 
-/* Vector */
+double dotOf(Kernels const & kernels, float const * x, float const * y, size_t dim) {
+    return kernels.dotFloat(x, y, dim);
+}
 
-Vector::Vector(size_t dim, double * pData, ILogger * pLogger) : IVector(), Loggable(pLogger), dim(dim), coords(pData) {}
+double distance1Of(Kernels const & kernels, double const * x, double const * y, size_t dim) {
+    return kernels.distance1(x, y, dim);
+}
 
-Vector::~Vector() {
-    delete [] coords;
-    coords = nullptr;
+double distance1Of(Kernels const & kernels, float const * x, float const * y, size_t dim) {
+    return kernels.distance1Float(x, y, dim);
 }
 
-IVector * Vector::clone() const {
-    return IVector::createVector(dim, coords, logger);
+double distance2SquaredOf(Kernels const & kernels, double const * x, double const * y, size_t dim) {
+    return kernels.distance2Squared(x, y, dim);
 }
 
-double Vector::getCoord(size_t index) const {
-    char const * during = "IVector::getCoord";
+double distance2SquaredOf(Kernels const & kernels, float const * x, float const * y, size_t dim) {
+    return kernels.distance2SquaredFloat(x, y, dim);
+}
 
-    if(index >= dim) {
-        printLogDuring("Index of vector in set out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+double distanceInfOf(Kernels const & kernels, double const * x, double const * y, size_t dim) {
+    return kernels.distanceInf(x, y, dim);
+}
 
-        return std::numeric_limits <double>::quiet_NaN();
-    }
+double distanceInfOf(Kernels const & kernels, float const * x, float const * y, size_t dim) {
+    return kernels.distanceInfFloat(x, y, dim);
+}
 
-    return coords[index];
+bool hasNaNOf(Kernels const & kernels, double const * x, size_t dim) {
+    return kernels.hasNaN(x, dim);
 }
 
-RESULT_CODE Vector::setCoord(size_t index, double value) {
-    char const * during = "IVector::setCoord";
+bool hasNaNOf(Kernels const & kernels, float const * x, size_t dim) {
+    return kernels.hasNaNFloat(x, dim);
+}
 
-    if(index >= dim) {
-        return printLogDuring("Error in setting coord index", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
-    }
 
-    if(std::isnan(value)) {
-        return printLogDuring("Coord value is equal to NaN", during, RESULT_CODE::NAN_VALUE, logger);
+template <typename T>
+double normCoords(T const * x, size_t dim, IVector::NORM norm) {
+    Kernels const & kernels = Kernels::get();
+
+    switch(norm) {
+    case IVector::NORM::NORM_1:
+        return reduceChunks(dim, false, [&](size_t begin, size_t size) {
+            return norm1Of(kernels, x + begin, size);
+        });
+
+    case IVector::NORM::NORM_2:
+        return std::sqrt(reduceChunks(dim, false, [&](size_t begin, size_t size) {
+            return norm2SquaredOf(kernels, x + begin, size);
+        }));
+
+    case IVector::NORM::NORM_INF:
+        return reduceChunks(dim, true, [&](size_t begin, size_t size) {
+            return normInfOf(kernels, x + begin, size);
+        });
     }
 
-    coords[index] = value;
+    return std::numeric_limits <double>::quiet_NaN();
+}
 
-    return RESULT_CODE::SUCCESS;
+template <typename T>
+double dotCoords(T const * x, T const * y, size_t dim) {
+    Kernels const & kernels = Kernels::get();
+
+    return reduceChunks(dim, false, [&](size_t begin, size_t size) {
+        return dotOf(kernels, x + begin, y + begin, size);
+    });
 }
 
-double Vector::norm(NORM norm) const {
-    char const * during = "IVector::norm";
-    double normResult = 0.;
+template <typename T>
+double distanceCoords(T const * x, T const * y, size_t dim, IVector::NORM norm) {
+    Kernels const & kernels = Kernels::get();
 
     switch(norm) {
-    case NORM::NORM_1: {
-        for(size_t i = 0; i < dim; ++i) {
-            normResult += std::fabs(coords[i]);
-        }
-
-        break;
+    case IVector::NORM::NORM_1:
+        return reduceChunks(dim, false, [&](size_t begin, size_t size) {
+            return distance1Of(kernels, x + begin, y + begin, size);
+        });
+
+    case IVector::NORM::NORM_2:
+        return std::sqrt(reduceChunks(dim, false, [&](size_t begin, size_t size) {
+            return distance2SquaredOf(kernels, x + begin, y + begin, size);
+        }));
+
+    case IVector::NORM::NORM_INF:
+        return reduceChunks(dim, true, [&](size_t begin, size_t size) {
+            return distanceInfOf(kernels, x + begin, y + begin, size);
+        });
     }
 
-    case NORM::NORM_2: {
-        for(size_t i = 0; i < dim; ++i) {
-            normResult += coords[i] * coords[i];
-        }
+    return std::numeric_limits <double>::quiet_NaN();
+}
+
+/* blocks grow geometrically so that early misses cost only a few coordinates */
+template <typename T>
+bool withinCoords(T const * x, T const * y, size_t dim, IVector::NORM norm, double tolerance) {
+    size_t const FIRST_BLOCK = 8, MAX_BLOCK = 512;
+    Kernels const & kernels = Kernels::get();
+    double bound = norm == IVector::NORM::NORM_2 ? tolerance * tolerance : tolerance;
+    double result = 0.;
 
-        normResult = sqrt(normResult);
+    for(size_t i = 0, block = FIRST_BLOCK; i < dim; i += block, block = std::min(2 * block, MAX_BLOCK)) {
+        size_t length = std::min(block, dim - i);
 
-        break;
-    }
+        switch(norm) {
+        case IVector::NORM::NORM_1:
+            result += distance1Of(kernels, x + i, y + i, length);
+            break;
 
-    case NORM::NORM_INF: {
-        for(size_t i = 0; i < dim; ++i) {
-            double coordAbs = std::fabs(coords[i]);
+        case IVector::NORM::NORM_2:
+            result += distance2SquaredOf(kernels, x + i, y + i, length);
+            break;
 
-            if(coordAbs > normResult) {
-                normResult = coordAbs;
-            }
+        case IVector::NORM::NORM_INF:
+            result = std::max(result, distanceInfOf(kernels, x + i, y + i, length));
+            break;
         }
 
-        break;
+        if(!(result <= bound)) {
+            return false;
+        }
     }
 
-    default: {
-        printLogDuring("Invalid value of norm", during, RESULT_CODE::WRONG_ARGUMENT, logger);
-        normResult = std::numeric_limits <double>::quiet_NaN();
+    return true;
+}
 
-        break;
-    }
+bool withinGeneric(IVector const * pOperand1, IVector const * pOperand2, IVector::NORM norm, double tolerance) {
+    size_t dim = pOperand1->getDim();
+    double bound = norm == IVector::NORM::NORM_2 ? tolerance * tolerance : tolerance;
+    double result = 0.;
+
+    for(size_t i = 0; i < dim; ++i) {
+        double diff = std::fabs(pOperand1->getCoord(i) - pOperand2->getCoord(i));
+
+        switch(norm) {
+        case IVector::NORM::NORM_1:
+            result += diff;
+            break;
+
+        case IVector::NORM::NORM_2:
+            result += diff * diff;
+            break;
+
+        case IVector::NORM::NORM_INF:
+            result = std::max(result, diff);
+            break;
+        }
+
+        if(!(result <= bound)) {
+            return false;
+        }
     }
 
-    return normResult;
+    return true;
 }
 
-size_t Vector::getDim() const {
-    return dim;
+bool kernelResultsMatch(double result, double reference) {
+    return std::fabs(result - reference) <= 1e-10 * std::max(1., std::fabs(reference));
 }
 
-Vector * Vector::createVector(size_t dim, double * pData, ILogger * pLogger) {
-    char const * during = "IVector::createVector";
+/* NaN is put into index of both arrays and taken out afterwards */
+bool nanFoundAt(Kernels const & kernels, double * x, float * xFloat, size_t index, size_t dim) {
+    double saved = x[index];
+    float savedFloat = xFloat[index];
 
-    if(dim == 0) {
-        printLogDuring("Trying to create a zero-dimensional vector", during, RESULT_CODE::WRONG_DIM, pLogger);
+    x[index] = std::numeric_limits <double>::quiet_NaN();
+    xFloat[index] = std::numeric_limits <float>::quiet_NaN();
 
-        return nullptr;
-    }
+    bool found = kernels.hasNaN(x, dim) && kernels.hasNaNFloat(xFloat, dim);
 
-    if(pData == nullptr) {
-        printLogDuring("Trying to create a vector with nullptr coordinates array", during, RESULT_CODE::BAD_REFERENCE,
-                       pLogger);
+    x[index] = saved;
+    xFloat[index] = savedFloat;
 
-        return nullptr;
+    return found;
+}
+
+/* block holds dim * Kernels::BATCH_LANES coordinates */
+bool batchKernelsMatch(Kernels const & kernels, Kernels const & reference, double const * block, double const * query,
+                       size_t dim) {
+    size_t const LANES = Kernels::BATCH_LANES;
+    double result[2 * LANES];
+    bool matches = true;
+
+    for(int operation = 0; operation < 7; ++operation) {
+        switch(operation) {
+        case 0:
+            kernels.batchNorm1(block, dim, result);
+            reference.batchNorm1(block, dim, result + LANES);
+            break;
+
+        case 1:
+            kernels.batchNorm2Squared(block, dim, result);
+            reference.batchNorm2Squared(block, dim, result + LANES);
+            break;
+
+        case 2:
+            kernels.batchNormInf(block, dim, result);
+            reference.batchNormInf(block, dim, result + LANES);
+            break;
+
+        case 3:
+            kernels.batchDot(block, query, dim, result);
+            reference.batchDot(block, query, dim, result + LANES);
+            break;
+
+        case 4:
+            kernels.batchDistance1(block, query, dim, result);
+            reference.batchDistance1(block, query, dim, result + LANES);
+            break;
+
+        case 5:
+            kernels.batchDistance2Squared(block, query, dim, result);
+            reference.batchDistance2Squared(block, query, dim, result + LANES);
+            break;
+
+        default:
+            kernels.batchDistanceInf(block, query, dim, result);
+            reference.batchDistanceInf(block, query, dim, result + LANES);
+            break;
+        }
+
+        for(size_t lane = 0; lane < LANES; ++lane) {
+            matches &= kernelResultsMatch(result[lane], result[LANES + lane]);
+        }
     }
 
-    for(size_t i = 0; i < dim; ++i) {
-        if(std::isnan(pData[i])) {
-            printLogDuring("NaN vector component was found", during, RESULT_CODE::NAN_VALUE, pLogger);
+    return matches;
+}
+
+/* matrix holds rows * cols coordinates, block cols * Kernels::BATCH_LANES ones */
+bool transformKernelsMatch(Kernels const & kernels, Kernels const & reference, double const * matrix,
+                           double const * block, size_t rows, size_t cols) {
+    size_t const LANES = Kernels::BATCH_LANES;
+    double result[2 * 8 * LANES];
 
-            return nullptr;
+    kernels.batchTransform(matrix, rows, cols, block, result);
+    reference.batchTransform(matrix, rows, cols, block, result + rows * LANES);
+
+    for(size_t i = 0; i < rows * LANES; ++i) {
+        if(!kernelResultsMatch(result[i], result[rows * LANES + i])) {
+            return false;
         }
     }
 
-    double * coords = new double[dim];
+    return true;
+}
+
+/* codes decode to 0.25 + 0.01 * code */
+bool codeKernelsMatch(Kernels const & kernels, Kernels const & reference, double const * query, int8_t const * codes8,
+                      int16_t const * codes16, size_t dim) {
+    double const SCALE = 0.01, OFFSET = 0.25;
+
+    return kernelResultsMatch(kernels.codeDistance1Int8(query, codes8, SCALE, OFFSET, dim),
+                              reference.codeDistance1Int8(query, codes8, SCALE, OFFSET, dim)) &&
+            kernelResultsMatch(kernels.codeDistance2SquaredInt8(query, codes8, SCALE, OFFSET, dim),
+                               reference.codeDistance2SquaredInt8(query, codes8, SCALE, OFFSET, dim)) &&
+            kernels.codeDistanceInfInt8(query, codes8, SCALE, OFFSET, dim) ==
+            reference.codeDistanceInfInt8(query, codes8, SCALE, OFFSET, dim) &&
+            kernelResultsMatch(kernels.codeDistance1Int16(query, codes16, SCALE, OFFSET, dim),
+                               reference.codeDistance1Int16(query, codes16, SCALE, OFFSET, dim)) &&
+            kernelResultsMatch(kernels.codeDistance2SquaredInt16(query, codes16, SCALE, OFFSET, dim),
+                               reference.codeDistance2SquaredInt16(query, codes16, SCALE, OFFSET, dim)) &&
+            kernels.codeDistanceInfInt16(query, codes16, SCALE, OFFSET, dim) ==
+            reference.codeDistanceInfInt16(query, codes16, SCALE, OFFSET, dim);
+}
 
-    if(coords == nullptr) {
-        printLogDuring("Not enough memory to create the coordinates array", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+double distanceGeneric(IVector const * pOperand1, IVector const * pOperand2, IVector::NORM norm) {
+    size_t dim = pOperand1->getDim();
+    double result = 0.;
 
-        return nullptr;
+    switch(norm) {
+    case IVector::NORM::NORM_1: {
+        for(size_t i = 0; i < dim; ++i) {
+            result += std::fabs(pOperand1->getCoord(i) - pOperand2->getCoord(i));
+        }
+
+        return result;
     }
 
-    memcpy(coords, pData, dim * sizeof(double));
-    Vector * vec = new Vector(dim, coords, pLogger);
+    case IVector::NORM::NORM_2: {
+        for(size_t i = 0; i < dim; ++i) {
+            double diff = pOperand1->getCoord(i) - pOperand2->getCoord(i);
+            result += diff * diff;
+        }
 
-    if(vec == nullptr) {
-        printLogDuring("Not enough memory to create the vector", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+        return std::sqrt(result);
     }
 
-    return vec;
+    case IVector::NORM::NORM_INF: {
+        for(size_t i = 0; i < dim; ++i) {
+            result = std::max(result, std::fabs(pOperand1->getCoord(i) - pOperand2->getCoord(i)));
+        }
+
+        return result;
+    }
+    }
+
+    return std::numeric_limits <double>::quiet_NaN();
+}
+
+
+
+/* IVector */
+
+IVector::~IVector() = default;
+
+IVector * IVector::createVector(size_t dim, double * pData, ILogger * pLogger) {
+    return Vector <double>::createVector(dim, pData, pLogger, nullptr, false);
+}
+
+IVector * IVector::createVector(size_t dim, double * pData, ILogger * pLogger, IVectorArena * pArena) {
+    return Vector <double>::createVector(dim, pData, pLogger, pArena, false);
+}
+
+IVector * IVector::createTrustedVector(size_t dim, double const * pData, ILogger * pLogger) {
+    return Vector <double>::createVector(dim, pData, pLogger, nullptr, true);
+}
+
+IVector * IVector::createTrustedVector(size_t dim, double const * pData, ILogger * pLogger, IVectorArena * pArena) {
+    return Vector <double>::createVector(dim, pData, pLogger, pArena, true);
+}
+
+IVector * IVector::createFloatVector(size_t dim, float const * pData, ILogger * pLogger) {
+    return Vector <float>::createVector(dim, pData, pLogger, nullptr, false);
+}
+
+IVector * IVector::createFloatVector(size_t dim, float const * pData, ILogger * pLogger, IVectorArena * pArena) {
+    return Vector <float>::createVector(dim, pData, pLogger, pArena, false);
+}
+
+void IVector::setParallelThreshold(size_t dim) {
+    parallelThreshold.store(dim, std::memory_order_relaxed);
+}
+
+size_t IVector::getParallelThreshold() {
+    return parallelThreshold.load(std::memory_order_relaxed);
+}
+
+bool IVector::hasNaN(double const * pData, size_t dim) {
+    return pData != nullptr && Kernels::get().hasNaN(pData, dim);
+}
+
+IVector * IVector::createSparseVector(size_t dim, size_t count, size_t const * pIndices, double const * pValues,
+                                      ILogger * pLogger) {
+    return SparseVector::createVector(dim, count, pIndices, pValues, pLogger);
+}
+
+IVector * IVector::createView(size_t dim, double * pData, ILogger * pLogger) {
+    return VectorView::createView(dim, pData, false, pLogger);
+}
+
+IVector * IVector::createReadOnlyView(size_t dim, double const * pData, ILogger * pLogger) {
+    //the coordinates are never written through a read-only view
+    return VectorView::createView(dim, const_cast <double *> (pData), true, pLogger);
+}
+
+IVector * IVector::add(IVector const * pOperand1, IVector const * pOperand2, ILogger * pLogger) {
+    char const * during = "IVector::add";
+
+    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger) || !equalDims(pOperand1, pOperand2, during, pLogger)) {
+        return nullptr;
+    }
+
+    IVector * result = writableClone(pOperand1);
+
+    if(result == nullptr) {
+        Loggable::printLogDuring("Failed to clone first operand", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+
+        return nullptr;
+    }
+
+    if(IVector::addInPlace(result, pOperand2, pLogger) != RESULT_CODE::SUCCESS) {
+        Loggable::printLogDuring("Failed to add coordinates", during, RESULT_CODE::CALCULATION_ERROR, pLogger);
+
+        delete result;
+        result = nullptr;
+
+        return nullptr;
+    }
+
+    return result;
+}
+
+IVector * IVector::sub(IVector const * pOperand1, IVector const * pOperand2, ILogger * pLogger) {
+    char const * during = "IVector::sub";
+
+    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger) || !equalDims(pOperand1, pOperand2, during, pLogger)) {
+        return nullptr;
+    }
+
+    IVector * result = writableClone(pOperand1);
+
+    if(result == nullptr) {
+        Loggable::printLogDuring("Failed to clone first operand", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+
+        return nullptr;
+    }
+
+    if(IVector::subInPlace(result, pOperand2, pLogger) != RESULT_CODE::SUCCESS) {
+        Loggable::printLogDuring("Failed to subtract coordinates", during, RESULT_CODE::CALCULATION_ERROR, pLogger);
+
+        delete result;
+        result = nullptr;
+
+        return nullptr;
+    }
+
+    return result;
+}
+
+IVector * IVector::mul(IVector const * pOperand1, double scaleParam, ILogger * pLogger) {
+    char const * during = "IVector::mul";
+
+    if(pOperand1 == nullptr) {
+        Loggable::printLogDuring("First operand (vector) turned out to be equal to nullptr", during,
+                                 RESULT_CODE::BAD_REFERENCE, pLogger);
+
+        return nullptr;
+    }
+
+    if(std::isnan(scaleParam)) {
+        Loggable::printLogDuring("Second operand (scalar) turned out to be equal to NaN", during,
+                                 RESULT_CODE::NAN_VALUE, pLogger);
+
+        return nullptr;
+    }
+
+    IVector * result = writableClone(pOperand1);
+
+    if(result == nullptr) {
+        Loggable::printLogDuring("Failed to clone first operand (vector)", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+
+        return nullptr;
+    }
+
+    if(IVector::scaleInPlace(result, scaleParam, pLogger) != RESULT_CODE::SUCCESS) {
+        Loggable::printLogDuring("Failed to multiply coordinates", during, RESULT_CODE::CALCULATION_ERROR, pLogger);
+
+        delete result;
+        result = nullptr;
+
+        return nullptr;
+    }
+
+    return result;
+}
+
+double IVector::mul(IVector const * pOperand1, IVector const * pOperand2, ILogger * pLogger) {
+    char const * during = "IVector::mul";
+
+    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger) || !equalDims(pOperand1, pOperand2, during, pLogger)) {
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    double const * x = pOperand1->getData();
+    double const * y = pOperand2->getData();
+
+    if(x != nullptr && y != nullptr) {
+        return dotCoords(x, y, pOperand1->getDim());
+    }
+
+    if(SparseVector::from(pOperand1) != nullptr || SparseVector::from(pOperand2) != nullptr) {
+        return SparseVector::dot(pOperand1, pOperand2);
+    }
+
+    float const * xFloat = floatCoords(pOperand1);
+    float const * yFloat = xFloat == nullptr ? nullptr : floatCoords(pOperand2);
+
+    if(xFloat != nullptr && yFloat != nullptr) {
+        return dotCoords(xFloat, yFloat, pOperand1->getDim());
+    }
+
+    double result = 0.;
+
+    for(size_t i = 0; i < pOperand1->getDim(); ++i) {
+        result += pOperand1->getCoord(i) * pOperand2->getCoord(i);
+    }
+
+    return result;
+}
+
+RESULT_CODE IVector::add(IVector const * pOperand1, IVector const * pOperand2, IVector * pResult, ILogger * pLogger) {
+    char const * during = "IVector::add";
+
+    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger)) {
+        return RESULT_CODE::BAD_REFERENCE;
+    }
+
+    if(!equalDims(pOperand1, pOperand2, during, pLogger)) {
+        return RESULT_CODE::WRONG_DIM;
+    }
+
+    if(!resultHasDim(pResult, pOperand1->getDim(), during, pLogger)) {
+        return pResult == nullptr ? RESULT_CODE::BAD_REFERENCE : RESULT_CODE::WRONG_DIM;
+    }
+
+    return linearCombination(pResult, 1., pOperand1, 1., pOperand2, during, pLogger);
+}
+
+RESULT_CODE IVector::sub(IVector const * pOperand1, IVector const * pOperand2, IVector * pResult, ILogger * pLogger) {
+    char const * during = "IVector::sub";
+
+    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger)) {
+        return RESULT_CODE::BAD_REFERENCE;
+    }
+
+    if(!equalDims(pOperand1, pOperand2, during, pLogger)) {
+        return RESULT_CODE::WRONG_DIM;
+    }
+
+    if(!resultHasDim(pResult, pOperand1->getDim(), during, pLogger)) {
+        return pResult == nullptr ? RESULT_CODE::BAD_REFERENCE : RESULT_CODE::WRONG_DIM;
+    }
+
+    return linearCombination(pResult, 1., pOperand1, -1., pOperand2, during, pLogger);
+}
+
+RESULT_CODE IVector::mul(IVector const * pOperand1, double scaleParam, IVector * pResult, ILogger * pLogger) {
+    char const * during = "IVector::mul";
+
+    if(pOperand1 == nullptr) {
+        return Loggable::printLogDuring("First operand (vector) turned out to be equal to nullptr", during,
+                                        RESULT_CODE::BAD_REFERENCE, pLogger);
+    }
+
+    if(std::isnan(scaleParam)) {
+        return Loggable::printLogDuring("Second operand (scalar) turned out to be equal to NaN", during,
+                                        RESULT_CODE::NAN_VALUE, pLogger);
+    }
+
+    if(!resultHasDim(pResult, pOperand1->getDim(), during, pLogger)) {
+        return pResult == nullptr ? RESULT_CODE::BAD_REFERENCE : RESULT_CODE::WRONG_DIM;
+    }
+
+    return linearCombination(pResult, scaleParam, pOperand1, 0., nullptr, during, pLogger);
+}
+
+RESULT_CODE IVector::addInPlace(IVector * pOperand1, IVector const * pOperand2, ILogger * pLogger) {
+    char const * during = "IVector::addInPlace";
+
+    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger)) {
+        return RESULT_CODE::BAD_REFERENCE;
+    }
+
+    if(!equalDims(pOperand1, pOperand2, during, pLogger)) {
+        return RESULT_CODE::WRONG_DIM;
+    }
+
+    return linearCombination(pOperand1, 1., pOperand1, 1., pOperand2, during, pLogger);
+}
+
+RESULT_CODE IVector::subInPlace(IVector * pOperand1, IVector const * pOperand2, ILogger * pLogger) {
+    char const * during = "IVector::subInPlace";
+
+    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger)) {
+        return RESULT_CODE::BAD_REFERENCE;
+    }
+
+    if(!equalDims(pOperand1, pOperand2, during, pLogger)) {
+        return RESULT_CODE::WRONG_DIM;
+    }
+
+    return linearCombination(pOperand1, 1., pOperand1, -1., pOperand2, during, pLogger);
+}
+
+RESULT_CODE IVector::scaleInPlace(IVector * pOperand1, double scaleParam, ILogger * pLogger) {
+    char const * during = "IVector::scaleInPlace";
+
+    if(pOperand1 == nullptr) {
+        return Loggable::printLogDuring("First operand (vector) turned out to be equal to nullptr", during,
+                                        RESULT_CODE::BAD_REFERENCE, pLogger);
+    }
+
+    if(std::isnan(scaleParam)) {
+        return Loggable::printLogDuring("Second operand (scalar) turned out to be equal to NaN", during,
+                                        RESULT_CODE::NAN_VALUE, pLogger);
+    }
+
+    return linearCombination(pOperand1, scaleParam, pOperand1, 0., nullptr, during, pLogger);
+}
+
+RESULT_CODE IVector::axpy(IVector * pY, double a, IVector const * pX, ILogger * pLogger) {
+    char const * during = "IVector::axpy";
+
+    if(operandsAreNullptr(pY, pX, during, pLogger)) {
+        return RESULT_CODE::BAD_REFERENCE;
+    }
+
+    if(!equalDims(pY, pX, during, pLogger)) {
+        return RESULT_CODE::WRONG_DIM;
+    }
+
+    if(std::isnan(a)) {
+        return Loggable::printLogDuring("Scalar turned out to be equal to NaN", during, RESULT_CODE::NAN_VALUE, pLogger);
+    }
+
+    return linearCombination(pY, a, pX, 1., pY, during, pLogger);
+}
+
+double IVector::distance(IVector const * pOperand1, IVector const * pOperand2, NORM norm, ILogger * pLogger) {
+    char const * during = "IVector::distance";
+
+    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger) || !equalDims(pOperand1, pOperand2, during, pLogger)) {
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    if(norm != NORM::NORM_1 && norm != NORM::NORM_2 && norm != NORM::NORM_INF) {
+        Loggable::printLogDuring("Invalid value of norm", during, RESULT_CODE::WRONG_ARGUMENT, pLogger);
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    double const * x = pOperand1->getData();
+    double const * y = pOperand2->getData();
+
+    if(x != nullptr && y != nullptr) {
+        return distanceCoords(x, y, pOperand1->getDim(), norm);
+    }
+
+    if(SparseVector::from(pOperand1) != nullptr || SparseVector::from(pOperand2) != nullptr) {
+        return SparseVector::distance(pOperand1, pOperand2, norm);
+    }
+
+    float const * xFloat = floatCoords(pOperand1);
+    float const * yFloat = xFloat == nullptr ? nullptr : floatCoords(pOperand2);
+
+    if(xFloat != nullptr && yFloat != nullptr) {
+        return distanceCoords(xFloat, yFloat, pOperand1->getDim(), norm);
+    }
+
+    return distanceGeneric(pOperand1, pOperand2, norm);
+}
+
+RESULT_CODE IVector::equals(IVector const * pOperand1, IVector const * pOperand2, NORM norm, double tolerance,
+                            bool * result, ILogger * pLogger) {
+    char const * during = "IVector::equals";
+
+    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger)) {
+        return RESULT_CODE::BAD_REFERENCE;
+    }
+
+    if(!equalDims(pOperand1, pOperand2, during, pLogger)) {
+        return RESULT_CODE::WRONG_DIM;
+    }
+
+    if(std::isnan(tolerance)) {
+        return Loggable::printLogDuring("Tolerance equal to NaN is passed", during, RESULT_CODE::NAN_VALUE, pLogger);
+    }
+
+    if(tolerance < 0) {
+        return Loggable::printLogDuring("Tolerance less than zero is passed", during, RESULT_CODE::WRONG_ARGUMENT,
+                                        pLogger);
+    }
+
+    if(sharedCoords(pOperand1, pOperand2, norm)) {
+        *result = true;
+
+        return RESULT_CODE::SUCCESS;
+    }
+
+    double normDiff = IVector::distance(pOperand1, pOperand2, norm, pLogger);
+
+    if(std::isnan(normDiff)) {
+        return Loggable::printLogDuring("The norm of the difference between the operands turned out to be equal to NaN",
+                                        during, RESULT_CODE::NAN_VALUE, pLogger);
+    }
+
+    *result = normDiff <= tolerance;
+
+    return RESULT_CODE::SUCCESS;
+}
+
+
+RESULT_CODE IVector::withinTolerance(IVector const * pOperand1, IVector const * pOperand2, NORM norm,
+                                     double tolerance, bool * result, ILogger * pLogger) {
+    char const * during = "IVector::withinTolerance";
+
+    if(operandsAreNullptr(pOperand1, pOperand2, during, pLogger)) {
+        return RESULT_CODE::BAD_REFERENCE;
+    }
+
+    if(result == nullptr) {
+        return Loggable::printLogDuring("Result pointer turned out to be equal to nullptr", during,
+                                        RESULT_CODE::BAD_REFERENCE, pLogger);
+    }
+
+    if(!equalDims(pOperand1, pOperand2, during, pLogger)) {
+        return RESULT_CODE::WRONG_DIM;
+    }
+
+    if(std::isnan(tolerance)) {
+        return Loggable::printLogDuring("Tolerance equal to NaN is passed", during, RESULT_CODE::NAN_VALUE, pLogger);
+    }
+
+    if(tolerance < 0) {
+        return Loggable::printLogDuring("Tolerance less than zero is passed", during, RESULT_CODE::WRONG_ARGUMENT,
+                                        pLogger);
+    }
+
+    if(norm != NORM::NORM_1 && norm != NORM::NORM_2 && norm != NORM::NORM_INF) {
+        return Loggable::printLogDuring("Invalid value of norm", during, RESULT_CODE::WRONG_ARGUMENT, pLogger);
+    }
+
+    if(sharedCoords(pOperand1, pOperand2, norm)) {
+        *result = true;
+
+        return RESULT_CODE::SUCCESS;
+    }
+
+    double const * x = pOperand1->getData();
+    double const * y = pOperand2->getData();
+    float const * xFloat = x == nullptr ? floatCoords(pOperand1) : nullptr;
+    float const * yFloat = xFloat == nullptr ? nullptr : floatCoords(pOperand2);
+
+    if(x != nullptr && y != nullptr) {
+        *result = withinCoords(x, y, pOperand1->getDim(), norm, tolerance);
+    } else if(SparseVector::from(pOperand1) != nullptr || SparseVector::from(pOperand2) != nullptr) {
+        *result = SparseVector::within(pOperand1, pOperand2, norm, tolerance);
+    } else if(xFloat != nullptr && yFloat != nullptr) {
+        *result = withinCoords(xFloat, yFloat, pOperand1->getDim(), norm, tolerance);
+    } else {
+        *result = withinGeneric(pOperand1, pOperand2, norm, tolerance);
+    }
+
+    return RESULT_CODE::SUCCESS;
+}
+
+RESULT_CODE IVector::selfTest(ILogger * pLogger) {
+    char const * during = "IVector::selfTest";
+    size_t const MAX_DIM = 1031;
+    double * x = new double[MAX_DIM];
+    double * y = new double[MAX_DIM];
+    float * xFloat = new float[MAX_DIM];
+    float * yFloat = new float[MAX_DIM];
+    int8_t * yInt8 = new int8_t[MAX_DIM];
+    int16_t * yInt16 = new int16_t[MAX_DIM];
+    unsigned seed = 1;
+
+    for(size_t i = 0; i < MAX_DIM; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        x[i] = (double) (seed >> 8) / (1u << 24) * 2. - 1.;
+        seed = seed * 1103515245u + 12345u;
+        y[i] = (double) (seed >> 8) / (1u << 24) * 2. - 1.;
+        xFloat[i] = (float) x[i];
+        yFloat[i] = (float) y[i];
+        yInt8[i] = (int8_t) (y[i] * 127.);
+        yInt16[i] = (int16_t) (y[i] * 32767.);
+    }
+
+    Kernels const & reference = Kernels::reference();
+    RESULT_CODE result = RESULT_CODE::SUCCESS;
+
+    for(size_t b = 0; b < Kernels::getBackendsCount() && result == RESULT_CODE::SUCCESS; ++b) {
+        Kernels const & kernels = Kernels::getBackend(b);
+
+        if(!kernels.isSupported()) {
+            continue;
+        }
+
+        for(size_t dim = 0; dim <= MAX_DIM; dim += dim < 70 ? 1 : 137) {
+            bool matches = kernelResultsMatch(kernels.norm1(x, dim), reference.norm1(x, dim)) &&
+                    kernelResultsMatch(kernels.norm2Squared(x, dim), reference.norm2Squared(x, dim)) &&
+                    kernels.normInf(x, dim) == reference.normInf(x, dim) &&
+                    kernelResultsMatch(kernels.dot(x, y, dim), reference.dot(x, y, dim)) &&
+                    kernelResultsMatch(kernels.distance1(x, y, dim), reference.distance1(x, y, dim)) &&
+                    kernelResultsMatch(kernels.distance2Squared(x, y, dim), reference.distance2Squared(x, y, dim)) &&
+                    kernels.distanceInf(x, y, dim) == reference.distanceInf(x, y, dim) &&
+                    kernelResultsMatch(kernels.norm1Float(xFloat, dim), reference.norm1Float(xFloat, dim)) &&
+                    kernelResultsMatch(kernels.norm2SquaredFloat(xFloat, dim),
+                                       reference.norm2SquaredFloat(xFloat, dim)) &&
+                    kernels.normInfFloat(xFloat, dim) == reference.normInfFloat(xFloat, dim) &&
+                    kernelResultsMatch(kernels.dotFloat(xFloat, yFloat, dim), reference.dotFloat(xFloat, yFloat, dim)) &&
+                    kernelResultsMatch(kernels.distance1Float(xFloat, yFloat, dim),
+                                       reference.distance1Float(xFloat, yFloat, dim)) &&
+                    kernelResultsMatch(kernels.distance2SquaredFloat(xFloat, yFloat, dim),
+                                       reference.distance2SquaredFloat(xFloat, yFloat, dim)) &&
+                    kernels.distanceInfFloat(xFloat, yFloat, dim) == reference.distanceInfFloat(xFloat, yFloat, dim) &&
+                    kernelResultsMatch(kernels.weightedDistance1(x, y, x, dim),
+                                       reference.weightedDistance1(x, y, x, dim)) &&
+                    kernelResultsMatch(kernels.weightedDistance2Squared(x, y, x, dim),
+                                       reference.weightedDistance2Squared(x, y, x, dim)) &&
+                    kernels.weightedDistanceInf(x, y, x, dim) == reference.weightedDistanceInf(x, y, x, dim) &&
+                    codeKernelsMatch(kernels, reference, x, yInt8, yInt16, dim) &&
+                    (dim * Kernels::BATCH_LANES > MAX_DIM || batchKernelsMatch(kernels, reference, x, y, dim)) &&
+                    (dim * Kernels::BATCH_LANES > MAX_DIM ||
+                     transformKernelsMatch(kernels, reference, y, x, dim % 8 + 1, dim)) &&
+                    !kernels.hasNaN(x, dim) && !kernels.hasNaNFloat(xFloat, dim) &&
+                    (dim == 0 || nanFoundAt(kernels, x, xFloat, dim - 1, dim)) &&
+                    (dim == 0 || nanFoundAt(kernels, x, xFloat, dim / 2, dim));
+
+            if(!matches) {
+                char msg[128] = "Results differ from the scalar reference for backend ";
+
+                strcat(msg, kernels.name);
+                result = Loggable::printLogDuring(msg, during, RESULT_CODE::CALCULATION_ERROR, pLogger);
+
+                break;
+            }
+        }
+    }
+
+    delete [] x;
+    delete [] y;
+    delete [] xFloat;
+    delete [] yFloat;
+    delete [] yInt8;
+    delete [] yInt16;
+
+    x = nullptr;
+    y = nullptr;
+    xFloat = nullptr;
+    yFloat = nullptr;
+    yInt8 = nullptr;
+    yInt16 = nullptr;
+
+    return result;
+}
+
+
+/* Vector */
+
+template <typename T>
+Vector <T>::Vector(size_t dim, ILogger * pLogger) : IVector(), Loggable(pLogger), dim(dim) {
+    if(dim > INLINE_DIM) {
+        Extension * ext = new (extension()) Extension();
+
+        ext->coords = trailingCoords(this, dim);
+        ext->block = header(this);
+        ext->exposed.store(false, std::memory_order_relaxed);
+        invalidateNorms();
+    }
+}
+
+template <typename T>
+Vector <T>::Vector(size_t dim, T * sharedCoords, BlockHeader * sharedBlock, ILogger * pLogger) : IVector(),
+    Loggable(pLogger), dim(dim) {
+    Extension * ext = new (extension()) Extension();
+
+    ext->coords = sharedCoords;
+    ext->block = sharedBlock;
+    ext->block->refs.fetch_add(1, std::memory_order_relaxed);
+    ext->exposed.store(false, std::memory_order_relaxed);
+    invalidateNorms();
+}
+
+template <typename T>
+void Vector <T>::invalidateNorms() {
+    for(auto & norm : extension()->norms) {
+        norm.store(std::numeric_limits <double>::quiet_NaN(), std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+Vector <T>::~Vector() {
+    //the own block is released by operator delete
+    if(dim > INLINE_DIM) {
+        Extension * ext = extension();
+
+        if(ext->block != header(this)) {
+            release(ext->block);
+        }
+
+        ext->~Extension();
+    }
+}
+
+template <typename T>
+BlockHeader * Vector <T>::header(void const * pointer) {
+    return (BlockHeader *) ((char const *) pointer - HEADER_SIZE);
+}
+
+template <typename T>
+void Vector <T>::release(BlockHeader * block) {
+    if(block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        block->~BlockHeader();
+        ::operator delete(block);
+    }
+}
+
+template <typename T>
+typename Vector <T>::Extension * Vector <T>::extension() const {
+    return (Extension *) ((char *) this + sizeof(Vector));
+}
+
+template <typename T>
+T * Vector <T>::coords() const {
+    return dim > INLINE_DIM ? extension()->coords : trailingCoords((void *) this, dim);
+}
+
+template <typename T>
+bool Vector <T>::detach() {
+    //short vectors never share their coordinates
+    if(dim <= INLINE_DIM || extension()->block->refs.load(std::memory_order_acquire) == 1) {
+        return true;
+    }
+
+    void * memory = ::operator new(HEADER_SIZE + ALIGNMENT + dim * sizeof(T), std::nothrow);
+
+    if(memory == nullptr) {
+        return false;
+    }
+
+    Extension * ext = extension();
+    BlockHeader * copy = new (memory) BlockHeader();
+    size_t address = (size_t) memory + HEADER_SIZE;
+    T * copyCoords = (T *) ((address + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+
+    copy->arena = nullptr;
+    copy->refs.store(1, std::memory_order_relaxed);
+    memcpy(copyCoords, ext->coords, dim * sizeof(T));
+
+    //the own block stays referenced by this vector until it is deleted
+    if(ext->block != header(this)) {
+        release(ext->block);
+    }
+
+    ext->block = copy;
+    ext->coords = copyCoords;
+
+    return true;
+}
+
+template <typename T>
+size_t Vector <T>::extensionSize(size_t dim) {
+    return dim > INLINE_DIM ? sizeof(Extension) : 0;
+}
+
+template <typename T>
+T * Vector <T>::trailingCoords(void * pointer, size_t dim) {
+    size_t address = (size_t) pointer + sizeof(Vector) + extensionSize(dim);
+
+    return (T *) (dim > INLINE_DIM ? (address + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT : address);
+}
+
+template <typename T>
+void * Vector <T>::operator new(size_t size, size_t dim, IVectorArena * pArena, bool ownCoords) noexcept {
+    size += HEADER_SIZE + extensionSize(dim);
+    size += ownCoords ? dim * sizeof(T) + (dim > INLINE_DIM ? ALIGNMENT : 0) : 0;
+
+    void * memory = pArena == nullptr ? ::operator new(size, std::nothrow) : pArena->allocate(size, HEADER_SIZE);
+
+    if(memory == nullptr) {
+        return nullptr;
+    }
+
+    BlockHeader * block = new (memory) BlockHeader();
+
+    block->arena = pArena;
+    block->refs.store(1, std::memory_order_relaxed);
+
+    return (char *) memory + HEADER_SIZE;
+}
+
+template <typename T>
+void Vector <T>::operator delete(void * pointer) {
+    BlockHeader * block = header(pointer);
+
+    //arena blocks are released all together by IVectorArena::reset
+    if(block->arena == nullptr) {
+        release(block);
+    }
+}
+
+template <typename T>
+Vector <T> * Vector <T>::allocate(size_t dim, ILogger * pLogger, IVectorArena * pArena) {
+    Vector * vec = new (dim, pArena, true) Vector(dim, pLogger);
+
+    if(vec == nullptr) {
+        printLogDuring("Not enough memory to create the vector", "IVector::createVector", RESULT_CODE::OUT_OF_MEMORY,
+                       pLogger);
+    }
+
+    return vec;
+}
+
+template <typename T>
+IVector * Vector <T>::clone() const {
+    return clone(nullptr);
+}
+
+template <typename T>
+IVector * Vector <T>::clone(IVectorArena * pArena) const {
+    //long heap coordinates are shared until one of the vectors is written, arenas could release them under a clone
+    //and exposed ones may be written without notice
+    bool share = dim > INLINE_DIM && pArena == nullptr && extension()->block->arena == nullptr &&
+            !extension()->exposed.load(std::memory_order_relaxed);
+    Vector * vec = nullptr;
+
+    if(share) {
+        vec = new (dim, nullptr, false) Vector(dim, extension()->coords, extension()->block, logger);
+
+        if(vec == nullptr) {
+            printLogDuring("Not enough memory to create the vector", "IVector::clone", RESULT_CODE::OUT_OF_MEMORY,
+                           logger);
+        }
+
+        if(vec != nullptr) {
+            for(size_t i = 0; i < 3; ++i) {
+                vec->extension()->norms[i].store(extension()->norms[i].load(std::memory_order_relaxed),
+                                                 std::memory_order_relaxed);
+            }
+        }
+
+        return vec;
+    }
+
+    return copy(pArena);
+}
+
+template <typename T>
+Vector <T> * Vector <T>::copy(IVectorArena * pArena) const {
+    Vector * vec = allocate(dim, logger, pArena);
+
+    //coordinates of a vector are valid already
+    if(vec != nullptr) {
+        memcpy(vec->coords(), coords(), dim * sizeof(T));
+
+        for(size_t i = 0; i < 3 && dim > INLINE_DIM; ++i) {
+            vec->extension()->norms[i].store(extension()->norms[i].load(std::memory_order_relaxed),
+                                             std::memory_order_relaxed);
+        }
+    }
+
+    return vec;
+}
+
+template <typename T>
+double Vector <T>::getCoord(size_t index) const {
+    char const * during = "IVector::getCoord";
+
+    if(index >= dim) {
+        printLogDuring("Index of vector in set out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    return coords()[index];
+}
+
+template <typename T>
+RESULT_CODE Vector <T>::setCoord(size_t index, double value) {
+    char const * during = "IVector::setCoord";
+
+    if(index >= dim) {
+        return printLogDuring("Error in setting coord index", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+    }
+
+    if(std::isnan(value)) {
+        return printLogDuring("Coord value is equal to NaN", during, RESULT_CODE::NAN_VALUE, logger);
+    }
+
+    if(!detach()) {
+        return printLogDuring("Not enough memory to copy shared coordinates", during, RESULT_CODE::OUT_OF_MEMORY,
+                              logger);
+    }
+
+    coords()[index] = (T) value;
+
+    if(dim > INLINE_DIM) {
+        invalidateNorms();
+    }
+
+    return RESULT_CODE::SUCCESS;
+}
+
+template <typename T>
+double Vector <T>::norm(NORM norm) const {
+    char const * during = "IVector::norm";
+
+    if((norm == NORM::NORM_1 || norm == NORM::NORM_2 || norm == NORM::NORM_INF) && dim <= INLINE_DIM) {
+        return normCoords(coords(), dim, norm);
+    }
+
+    if(norm == NORM::NORM_1 || norm == NORM::NORM_2 || norm == NORM::NORM_INF) {
+        std::atomic <double> & cached = extension()->norms[(int) norm];
+        double result = cached.load(std::memory_order_relaxed);
+
+        if(std::isnan(result)) {
+            result = normCoords(coords(), dim, norm);
+            cacheNorm(norm, result);
+        }
+
+        return result;
+    }
+
+    printLogDuring("Invalid value of norm", during, RESULT_CODE::WRONG_ARGUMENT, logger);
+
+    return std::numeric_limits <double>::quiet_NaN();
+}
+
+template <typename T>
+size_t Vector <T>::getDim() const {
+    return dim;
+}
+
+template <typename T>
+double const * Vector <T>::getData() const {
+    return doubleCoords(coords());
+}
+
+template <typename T>
+double * Vector <T>::getMutableData() {
+    //single precision coordinates are not exposed, so there is nothing to copy for them
+    double * data = doubleCoords(coords()) == nullptr ? nullptr : doubleCoords(getMutableCoords());
+
+    //the caller may keep the pointer and write through it after any later norm call, so norms are not cached anymore
+    if(data != nullptr && dim > INLINE_DIM) {
+        extension()->exposed.store(true, std::memory_order_relaxed);
+    }
+
+    return data;
+}
+
+template <typename T>
+T const * Vector <T>::getCoords() const {
+    return coords();
+}
+
+template <typename T>
+T * Vector <T>::getMutableCoords() {
+    if(!detach()) {
+        printLogDuring("Not enough memory to copy shared coordinates", "IVector::getMutableData",
+                       RESULT_CODE::OUT_OF_MEMORY, logger);
+
+        return nullptr;
+    }
+
+    //the caller is about to write
+    if(dim > INLINE_DIM) {
+        invalidateNorms();
+    }
+
+    return coords();
+}
+
+template <typename T>
+void Vector <T>::cacheNorm(NORM norm, double value) const {
+    if(dim > INLINE_DIM && !extension()->exposed.load(std::memory_order_relaxed)) {
+        extension()->norms[(int) norm].store(value, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+Vector <T> * Vector <T>::createVector(size_t dim, T const * pData, ILogger * pLogger, IVectorArena * pArena,
+                                      bool trusted) {
+    char const * during = "IVector::createVector";
+
+    if(dim == 0) {
+        printLogDuring("Trying to create a zero-dimensional vector", during, RESULT_CODE::WRONG_DIM, pLogger);
+
+        return nullptr;
+    }
+
+    if(pData == nullptr) {
+        printLogDuring("Trying to create a vector with nullptr coordinates array", during, RESULT_CODE::BAD_REFERENCE,
+                       pLogger);
+
+        return nullptr;
+    }
+
+    assert(!trusted || !hasNaNOf(Kernels::get(), pData, dim));
+
+    if(!trusted && hasNaNOf(Kernels::get(), pData, dim)) {
+        printLogDuring("NaN vector component was found", during, RESULT_CODE::NAN_VALUE, pLogger);
+
+        return nullptr;
+    }
+
+    Vector * vec = allocate(dim, pLogger, pArena);
+
+    if(vec != nullptr) {
+        memcpy(vec->coords(), pData, dim * sizeof(T));
+    }
+
+    return vec;
+}
+
+
+
+/* VectorView */
+
+VectorView::VectorView(size_t dim, double * pData, bool readOnly, ILogger * pLogger) : IVector(), Loggable(pLogger),
+    dim(dim), coords(pData), readOnly(readOnly) {}
+
+VectorView::~VectorView() {
+    coords = nullptr;
+}
+
+IVector * VectorView::clone() const {
+    return clone(nullptr);
+}
+
+//clones own their coordinates
+IVector * VectorView::clone(IVectorArena * pArena) const {
+    return Vector <double>::createVector(dim, coords, logger, pArena, false);
+}
+
+double VectorView::getCoord(size_t index) const {
+    char const * during = "IVector::getCoord";
+
+    if(index >= dim) {
+        printLogDuring("Index of vector in set out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    return coords[index];
+}
+
+RESULT_CODE VectorView::setCoord(size_t index, double value) {
+    char const * during = "IVector::setCoord";
+
+    if(readOnly) {
+        return printLogDuring("Trying to modify a read-only view", during, RESULT_CODE::WRONG_ARGUMENT, logger);
+    }
+
+    if(index >= dim) {
+        return printLogDuring("Error in setting coord index", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+    }
+
+    if(std::isnan(value)) {
+        return printLogDuring("Coord value is equal to NaN", during, RESULT_CODE::NAN_VALUE, logger);
+    }
+
+    coords[index] = value;
+
+    return RESULT_CODE::SUCCESS;
+}
+
+double VectorView::norm(NORM norm) const {
+    char const * during = "IVector::norm";
+
+    if(norm == NORM::NORM_1 || norm == NORM::NORM_2 || norm == NORM::NORM_INF) {
+        return normCoords(coords, dim, norm);
+    }
+
+    printLogDuring("Invalid value of norm", during, RESULT_CODE::WRONG_ARGUMENT, logger);
+
+    return std::numeric_limits <double>::quiet_NaN();
+}
+
+size_t VectorView::getDim() const {
+    return dim;
+}
+
+double const * VectorView::getData() const {
+    return coords;
+}
+
+double * VectorView::getMutableData() {
+    return readOnly ? nullptr : coords;
+}
+
+VectorView * VectorView::createView(size_t dim, double * pData, bool readOnly, ILogger * pLogger) {
+    char const * during = "IVector::createView";
+
+    if(dim == 0) {
+        printLogDuring("Trying to create a zero-dimensional view", during, RESULT_CODE::WRONG_DIM, pLogger);
+
+        return nullptr;
+    }
+
+    if(pData == nullptr) {
+        printLogDuring("Trying to create a view of nullptr coordinates array", during, RESULT_CODE::BAD_REFERENCE,
+                       pLogger);
+
+        return nullptr;
+    }
+
+    VectorView * view = new (std::nothrow) VectorView(dim, pData, readOnly, pLogger);
+
+    if(view == nullptr) {
+        printLogDuring("Not enough memory to create the view", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+    }
+
+    return view;
 }
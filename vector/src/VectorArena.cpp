@@ -0,0 +1,166 @@
+#include <vector>
+#include <new>
+#include <algorithm>
+
+#include "../include/IVectorArena.h"
+#include "Loggable.h"
+
+
+
+namespace {
+class VectorArena : public IVectorArena, private Loggable {
+public:
+    ~VectorArena() override;
+    void * allocate(size_t size, size_t alignment) override;
+    void reset() override;
+    size_t getUsed() const override;
+    size_t getCapacity() const override;
+
+    static VectorArena * createArena(size_t chunkSize, ILogger * pLogger);
+
+private:
+    VectorArena(size_t chunkSize, ILogger * pLogger);
+    VectorArena(VectorArena const & anotherArena) = delete;
+    VectorArena & operator = (VectorArena const & anotherArena) = delete;
+
+    struct Chunk {
+        char * memory;
+        size_t size;
+    };
+
+    bool addChunk(size_t size);
+
+    size_t chunkSize;
+    std::vector <Chunk> chunks;
+    size_t current;
+    size_t offset;
+    size_t used;
+};
+}
+
+
+
+/* IVectorArena */
+
+IVectorArena::~IVectorArena() = default;
+
+IVectorArena * IVectorArena::createArena(size_t chunkSize, ILogger * pLogger) {
+    return VectorArena::createArena(chunkSize, pLogger);
+}
+
+
+
+/* VectorArena */
+
+VectorArena::VectorArena(size_t chunkSize, ILogger * pLogger) : IVectorArena(), Loggable(pLogger),
+    chunkSize(chunkSize), current(0), offset(0), used(0) {}
+
+VectorArena::~VectorArena() {
+    for(auto & chunk : chunks) {
+        delete [] chunk.memory;
+        chunk.memory = nullptr;
+    }
+
+    chunks.clear();
+}
+
+VectorArena * VectorArena::createArena(size_t chunkSize, ILogger * pLogger) {
+    char const * during = "IVectorArena::createArena";
+
+    if(chunkSize == 0) {
+        printLogDuring("Trying to create an arena with zero chunk size", during, RESULT_CODE::WRONG_ARGUMENT, pLogger);
+
+        return nullptr;
+    }
+
+    VectorArena * arena = new (std::nothrow) VectorArena(chunkSize, pLogger);
+
+    if(arena == nullptr) {
+        printLogDuring("Not enough memory to create the arena", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+
+        return nullptr;
+    }
+
+    if(!arena->addChunk(chunkSize)) {
+        delete arena;
+        arena = nullptr;
+    }
+
+    return arena;
+}
+
+bool VectorArena::addChunk(size_t size) {
+    Chunk chunk = {nullptr, size};
+
+    //the list has room for the chunk before it is allocated, so that it never leaks
+    try {
+        if(chunks.size() == chunks.capacity()) {
+            chunks.reserve(2 * chunks.size() + 1);
+        }
+
+        chunk.memory = new (std::nothrow) char[size];
+    } catch(std::bad_alloc const &) {
+        chunk.memory = nullptr;
+    }
+
+    if(chunk.memory == nullptr) {
+        printLogDuring("Not enough memory to create an arena chunk", "IVectorArena::allocate",
+                       RESULT_CODE::OUT_OF_MEMORY, logger);
+
+        return false;
+    }
+
+    chunks.push_back(chunk);
+
+    return true;
+}
+
+void * VectorArena::allocate(size_t size, size_t alignment) {
+    if(alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        printLogDuring("Alignment must be a power of two", "IVectorArena::allocate", RESULT_CODE::WRONG_ARGUMENT,
+                       logger);
+
+        return nullptr;
+    }
+
+    while(true) {
+        Chunk const & chunk = chunks[current];
+        size_t address = (size_t) chunk.memory + offset;
+        size_t padding = (alignment - address % alignment) % alignment;
+
+        if(offset + padding + size <= chunk.size) {
+            offset += padding + size;
+            used += padding + size;
+
+            return (void *) (address + padding);
+        }
+
+        //chunks left from a previous reset are reused before allocating new ones
+        if(current + 1 == chunks.size() && !addChunk(std::max(chunkSize, size + alignment))) {
+            return nullptr;
+        }
+
+        ++current;
+        offset = 0;
+    }
+}
+
+void VectorArena::reset() {
+    current = 0;
+    offset = 0;
+    used = 0;
+}
+
+size_t VectorArena::getUsed() const {
+    return used;
+}
+
+size_t VectorArena::getCapacity() const {
+    size_t capacity = 0;
+
+    for(auto const & chunk : chunks) {
+        capacity += chunk.size;
+    }
+
+    return capacity;
+}
@@ -0,0 +1,617 @@
+#include <cmath>
+#include <mem.h>
+#include <limits>
+#include <algorithm>
+#include <new>
+
+#include "../include/IVectorBatch.h"
+#include "Kernels.h"
+#include "Loggable.h"
+
+
+
+namespace {
+class VectorBatch : public IVectorBatch, private Loggable {
+public:
+    ~VectorBatch() override;
+    IVectorBatch * clone() const override;
+    size_t getCount() const override;
+    size_t getDim() const override;
+    double getCoord(size_t index, size_t coord) const override;
+    RESULT_CODE setCoord(size_t index, size_t coord, double value) override;
+    RESULT_CODE setVector(size_t index, IVector const * pVector) override;
+    IVector * createView(size_t index) override;
+    double const * getData() const override;
+    double * getMutableData() override;
+
+    static VectorBatch * createBatch(size_t count, size_t dim, ILogger * pLogger);
+
+private:
+    VectorBatch(size_t count, size_t dim, ILogger * pLogger);
+    VectorBatch(VectorBatch const & anotherBatch) = delete;
+    VectorBatch & operator = (VectorBatch const & anotherBatch) = delete;
+
+    static size_t const ALIGNMENT = 64;
+
+    size_t count;
+    size_t dim;
+    size_t size;
+    double * memory;
+    double * coords;
+};
+
+/* One vector of a batch, its coordinates are LANES apart */
+class BatchView : public IVector, private Loggable {
+public:
+    BatchView(double * pCoords, size_t dim, ILogger * pLogger);
+    ~BatchView() override;
+    IVector * clone() const override;
+    IVector * clone(IVectorArena * pArena) const override;
+    double getCoord(size_t index) const override;
+    RESULT_CODE setCoord(size_t index, double value) override;
+    double norm(NORM norm) const override;
+    size_t getDim() const override;
+    double const * getData() const override;
+    double * getMutableData() override;
+
+private:
+    BatchView() = delete;
+    BatchView(BatchView const & anotherView) = delete;
+    BatchView & operator = (BatchView const & anotherView) = delete;
+
+    static size_t const STRIDE = IVectorBatch::LANES;
+
+    double * coords;
+    size_t dim;
+};
+}
+
+
+
+/* Secondary functions */
+
+static_assert(IVectorBatch::LANES == Kernels::BATCH_LANES, "Batch layout does not match the batched kernels");
+
+namespace {
+size_t paddedCount(size_t count) {
+    return (count + IVectorBatch::LANES - 1) / IVectorBatch::LANES * IVectorBatch::LANES;
+}
+
+bool batchesMatch(IVectorBatch const * pOperand1, IVectorBatch const * pOperand2, char const * during,
+                  ILogger * pLogger) {
+    if(pOperand1->getCount() != pOperand2->getCount() || pOperand1->getDim() != pOperand2->getDim()) {
+        Loggable::printLogDuring("The counts or the dimensions of the batches are not equal", during,
+                                 RESULT_CODE::WRONG_DIM, pLogger);
+
+        return false;
+    }
+
+    return true;
+}
+
+/* unused lanes are zero, so operations keep them zero except multiplication by infinity */
+void clearPadding(IVectorBatch * pBatch) {
+    size_t const LANES = IVectorBatch::LANES;
+    size_t count = pBatch->getCount(), dim = pBatch->getDim();
+    double * last = pBatch->getMutableData() + (paddedCount(count) - LANES) * dim;
+
+    for(size_t j = 0; j < dim; ++j) {
+        for(size_t lane = (count - 1) % LANES + 1; lane < LANES; ++lane) {
+            last[j * LANES + lane] = 0.;
+        }
+    }
+}
+
+/* alpha * x + beta * y at index i of the interleaved buffers, y may be nullptr */
+inline double combination(double alpha, double const * x, double beta, double const * y, size_t i) {
+    return y == nullptr ? alpha * x[i] : alpha * x[i] + beta * y[i];
+}
+
+/* result = alpha * x + beta * y over the whole buffer, y may be nullptr; the result is left unchanged
+   if a NaN coordinate would be obtained */
+RESULT_CODE combineBatches(IVectorBatch * pResult, double alpha, IVectorBatch const * pX, double beta,
+                           IVectorBatch const * pY, char const * during, ILogger * pLogger) {
+    size_t const LANES = IVectorBatch::LANES;
+    Kernels const & kernels = Kernels::get();
+    size_t count = pResult->getCount(), dim = pResult->getDim();
+    size_t size = paddedCount(count) * dim;
+    double const * x = pX->getData();
+    double const * y = pY == nullptr ? nullptr : pY->getData();
+    //no coordinate overflows within a finite bound, so none is NaN
+    double bound = std::fabs(alpha) * kernels.normInf(x, size);
+    bool paddingNaN = false;
+
+    if(y != nullptr) {
+        bound += std::fabs(beta) * kernels.normInf(y, size);
+    }
+
+    //otherwise checked before writing, since the result may be one of the operands; zero padding lanes turn into NaN
+    //only when multiplied by infinity, they are cleared after writing
+    for(size_t i = 0; i < size && !std::isfinite(bound); ++i) {
+        if(!std::isnan(combination(alpha, x, beta, y, i))) {
+            continue;
+        }
+
+        if(i / (dim * LANES) * LANES + i % LANES < count) {
+            return Loggable::printLogDuring("NaN coordinate would be obtained, the result batch is left unchanged",
+                                            during, RESULT_CODE::CALCULATION_ERROR, pLogger);
+        }
+
+        paddingNaN = true;
+    }
+
+    double * result = pResult->getMutableData();
+
+    for(size_t i = 0; i < size; ++i) {
+        result[i] = combination(alpha, x, beta, y, i);
+    }
+
+    if(paddingNaN) {
+        clearPadding(pResult);
+    }
+
+    return RESULT_CODE::SUCCESS;
+}
+
+/* query coordinates as one array, copied into buffer if the vector does not keep them so */
+double const * queryCoords(IVector const * pQuery, double * & buffer) {
+    double const * query = pQuery->getData();
+
+    if(query != nullptr) {
+        return query;
+    }
+
+    buffer = new (std::nothrow) double[pQuery->getDim()];
+
+    if(buffer != nullptr) {
+        for(size_t i = 0; i < pQuery->getDim(); ++i) {
+            buffer[i] = pQuery->getCoord(i);
+        }
+    }
+
+    return buffer;
+}
+
+/* runs a batched kernel block by block, pQuery may be nullptr for norms */
+RESULT_CODE forEachBlock(IVectorBatch const * pBatch, IVector const * pQuery, IVector::NORM norm, bool dot,
+                         double * pResults, char const * during, ILogger * pLogger) {
+    size_t const LANES = IVectorBatch::LANES;
+    size_t count = pBatch->getCount(), dim = pBatch->getDim();
+    double * buffer = nullptr;
+    double const * query = pQuery == nullptr ? nullptr : queryCoords(pQuery, buffer);
+
+    if(pQuery != nullptr && query == nullptr) {
+        return Loggable::printLogDuring("Not enough memory to copy the query", during, RESULT_CODE::OUT_OF_MEMORY,
+                                        pLogger);
+    }
+
+    Kernels const & kernels = Kernels::get();
+    double lanes[LANES];
+
+    for(size_t first = 0; first < count; first += LANES) {
+        double const * block = pBatch->getData() + first * dim;
+
+        if(dot) {
+            kernels.batchDot(block, query, dim, lanes);
+        } else if(query == nullptr) {
+            switch(norm) {
+            case IVector::NORM::NORM_1:
+                kernels.batchNorm1(block, dim, lanes);
+                break;
+
+            case IVector::NORM::NORM_2:
+                kernels.batchNorm2Squared(block, dim, lanes);
+                break;
+
+            case IVector::NORM::NORM_INF:
+                kernels.batchNormInf(block, dim, lanes);
+                break;
+            }
+        } else {
+            switch(norm) {
+            case IVector::NORM::NORM_1:
+                kernels.batchDistance1(block, query, dim, lanes);
+                break;
+
+            case IVector::NORM::NORM_2:
+                kernels.batchDistance2Squared(block, query, dim, lanes);
+                break;
+
+            case IVector::NORM::NORM_INF:
+                kernels.batchDistanceInf(block, query, dim, lanes);
+                break;
+            }
+        }
+
+        for(size_t lane = 0; lane < LANES && first + lane < count; ++lane) {
+            pResults[first + lane] = !dot && norm == IVector::NORM::NORM_2 ? std::sqrt(lanes[lane]) : lanes[lane];
+        }
+    }
+
+    delete [] buffer;
+    buffer = nullptr;
+
+    return RESULT_CODE::SUCCESS;
+}
+
+bool validNorm(IVector::NORM norm, char const * during, ILogger * pLogger) {
+    if(norm != IVector::NORM::NORM_1 && norm != IVector::NORM::NORM_2 && norm != IVector::NORM::NORM_INF) {
+        Loggable::printLogDuring("Invalid value of norm", during, RESULT_CODE::WRONG_ARGUMENT, pLogger);
+
+        return false;
+    }
+
+    return true;
+}
+}
+
+
+
+/* IVectorBatch */
+
+IVectorBatch::~IVectorBatch() = default;
+
+IVectorBatch * IVectorBatch::createBatch(size_t count, size_t dim, ILogger * pLogger) {
+    return VectorBatch::createBatch(count, dim, pLogger);
+}
+
+RESULT_CODE IVectorBatch::add(IVectorBatch const * pOperand1, IVectorBatch const * pOperand2, IVectorBatch * pResult,
+                              ILogger * pLogger) {
+    char const * during = "IVectorBatch::add";
+
+    if(pOperand1 == nullptr || pOperand2 == nullptr || pResult == nullptr) {
+        return Loggable::printLogDuring("Operand or result batch turned out to be equal to nullptr", during,
+                                        RESULT_CODE::BAD_REFERENCE, pLogger);
+    }
+
+    if(!batchesMatch(pOperand1, pOperand2, during, pLogger) || !batchesMatch(pOperand1, pResult, during, pLogger)) {
+        return RESULT_CODE::WRONG_DIM;
+    }
+
+    return combineBatches(pResult, 1., pOperand1, 1., pOperand2, during, pLogger);
+}
+
+RESULT_CODE IVectorBatch::sub(IVectorBatch const * pOperand1, IVectorBatch const * pOperand2, IVectorBatch * pResult,
+                              ILogger * pLogger) {
+    char const * during = "IVectorBatch::sub";
+
+    if(pOperand1 == nullptr || pOperand2 == nullptr || pResult == nullptr) {
+        return Loggable::printLogDuring("Operand or result batch turned out to be equal to nullptr", during,
+                                        RESULT_CODE::BAD_REFERENCE, pLogger);
+    }
+
+    if(!batchesMatch(pOperand1, pOperand2, during, pLogger) || !batchesMatch(pOperand1, pResult, during, pLogger)) {
+        return RESULT_CODE::WRONG_DIM;
+    }
+
+    return combineBatches(pResult, 1., pOperand1, -1., pOperand2, during, pLogger);
+}
+
+RESULT_CODE IVectorBatch::mul(IVectorBatch const * pOperand1, double scaleParam, IVectorBatch * pResult,
+                              ILogger * pLogger) {
+    char const * during = "IVectorBatch::mul";
+
+    if(pOperand1 == nullptr || pResult == nullptr) {
+        return Loggable::printLogDuring("Operand or result batch turned out to be equal to nullptr", during,
+                                        RESULT_CODE::BAD_REFERENCE, pLogger);
+    }
+
+    if(std::isnan(scaleParam)) {
+        return Loggable::printLogDuring("Scalar turned out to be equal to NaN", during, RESULT_CODE::NAN_VALUE, pLogger);
+    }
+
+    if(!batchesMatch(pOperand1, pResult, during, pLogger)) {
+        return RESULT_CODE::WRONG_DIM;
+    }
+
+    return combineBatches(pResult, scaleParam, pOperand1, 0., nullptr, during, pLogger);
+}
+
+RESULT_CODE IVectorBatch::mul(IVectorBatch const * pBatch, IVector const * pQuery, double * pResults,
+                              ILogger * pLogger) {
+    char const * during = "IVectorBatch::mul";
+
+    if(pBatch == nullptr || pQuery == nullptr || pResults == nullptr) {
+        return Loggable::printLogDuring("Batch, query or results turned out to be equal to nullptr", during,
+                                        RESULT_CODE::BAD_REFERENCE, pLogger);
+    }
+
+    if(pBatch->getDim() != pQuery->getDim()) {
+        return Loggable::printLogDuring("The dimensions of the batch and the query are not equal", during,
+                                        RESULT_CODE::WRONG_DIM, pLogger);
+    }
+
+    return forEachBlock(pBatch, pQuery, IVector::NORM::NORM_2, true, pResults, during, pLogger);
+}
+
+RESULT_CODE IVectorBatch::norm(IVectorBatch const * pBatch, IVector::NORM norm, double * pResults, ILogger * pLogger) {
+    char const * during = "IVectorBatch::norm";
+
+    if(pBatch == nullptr || pResults == nullptr) {
+        return Loggable::printLogDuring("Batch or results turned out to be equal to nullptr", during,
+                                        RESULT_CODE::BAD_REFERENCE, pLogger);
+    }
+
+    if(!validNorm(norm, during, pLogger)) {
+        return RESULT_CODE::WRONG_ARGUMENT;
+    }
+
+    return forEachBlock(pBatch, nullptr, norm, false, pResults, during, pLogger);
+}
+
+RESULT_CODE IVectorBatch::distance(IVectorBatch const * pBatch, IVector const * pQuery, IVector::NORM norm,
+                                   double * pResults, ILogger * pLogger) {
+    char const * during = "IVectorBatch::distance";
+
+    if(pBatch == nullptr || pQuery == nullptr || pResults == nullptr) {
+        return Loggable::printLogDuring("Batch, query or results turned out to be equal to nullptr", during,
+                                        RESULT_CODE::BAD_REFERENCE, pLogger);
+    }
+
+    if(pBatch->getDim() != pQuery->getDim()) {
+        return Loggable::printLogDuring("The dimensions of the batch and the query are not equal", during,
+                                        RESULT_CODE::WRONG_DIM, pLogger);
+    }
+
+    if(!validNorm(norm, during, pLogger)) {
+        return RESULT_CODE::WRONG_ARGUMENT;
+    }
+
+    return forEachBlock(pBatch, pQuery, norm, false, pResults, during, pLogger);
+}
+
+
+
+/* VectorBatch */
+
+VectorBatch::VectorBatch(size_t count, size_t dim, ILogger * pLogger) : IVectorBatch(), Loggable(pLogger),
+    count(count), dim(dim), size(paddedCount(count) * dim), memory(nullptr), coords(nullptr) {}
+
+VectorBatch::~VectorBatch() {
+    delete [] memory;
+
+    memory = nullptr;
+    coords = nullptr;
+}
+
+VectorBatch * VectorBatch::createBatch(size_t count, size_t dim, ILogger * pLogger) {
+    char const * during = "IVectorBatch::createBatch";
+
+    if(count == 0 || dim == 0) {
+        printLogDuring("Trying to create an empty batch or a batch of zero-dimensional vectors", during,
+                       RESULT_CODE::WRONG_DIM, pLogger);
+
+        return nullptr;
+    }
+
+    VectorBatch * batch = new (std::nothrow) VectorBatch(count, dim, pLogger);
+
+    if(batch != nullptr) {
+        batch->memory = new (std::nothrow) double[batch->size + ALIGNMENT / sizeof(double)];
+    }
+
+    if(batch == nullptr || batch->memory == nullptr) {
+        printLogDuring("Not enough memory to create the batch", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+
+        delete batch;
+        batch = nullptr;
+
+        return nullptr;
+    }
+
+    size_t address = (size_t) batch->memory;
+
+    batch->coords = (double *) ((address + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+    memset(batch->coords, 0, batch->size * sizeof(double));
+
+    return batch;
+}
+
+IVectorBatch * VectorBatch::clone() const {
+    VectorBatch * batch = createBatch(count, dim, logger);
+
+    if(batch != nullptr) {
+        memcpy(batch->coords, coords, size * sizeof(double));
+    }
+
+    return batch;
+}
+
+size_t VectorBatch::getCount() const {
+    return count;
+}
+
+size_t VectorBatch::getDim() const {
+    return dim;
+}
+
+double VectorBatch::getCoord(size_t index, size_t coord) const {
+    char const * during = "IVectorBatch::getCoord";
+
+    if(index >= count || coord >= dim) {
+        printLogDuring("Index of vector or coordinate out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    return coords[(index / LANES * dim + coord) * LANES + index % LANES];
+}
+
+RESULT_CODE VectorBatch::setCoord(size_t index, size_t coord, double value) {
+    char const * during = "IVectorBatch::setCoord";
+
+    if(index >= count || coord >= dim) {
+        return printLogDuring("Index of vector or coordinate out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS,
+                              logger);
+    }
+
+    if(std::isnan(value)) {
+        return printLogDuring("Coord value is equal to NaN", during, RESULT_CODE::NAN_VALUE, logger);
+    }
+
+    coords[(index / LANES * dim + coord) * LANES + index % LANES] = value;
+
+    return RESULT_CODE::SUCCESS;
+}
+
+RESULT_CODE VectorBatch::setVector(size_t index, IVector const * pVector) {
+    char const * during = "IVectorBatch::setVector";
+
+    if(pVector == nullptr) {
+        return printLogDuring("Vector turned out to be equal to nullptr", during, RESULT_CODE::BAD_REFERENCE, logger);
+    }
+
+    if(index >= count) {
+        return printLogDuring("Index of vector out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+    }
+
+    if(pVector->getDim() != dim) {
+        return printLogDuring("The dimensions of the batch and the vector are not equal", during,
+                              RESULT_CODE::WRONG_DIM, logger);
+    }
+
+    double * first = coords + index / LANES * dim * LANES + index % LANES;
+    double const * data = pVector->getData();
+
+    for(size_t j = 0; j < dim; ++j) {
+        first[j * LANES] = data != nullptr ? data[j] : pVector->getCoord(j);
+    }
+
+    return RESULT_CODE::SUCCESS;
+}
+
+IVector * VectorBatch::createView(size_t index) {
+    char const * during = "IVectorBatch::createView";
+
+    if(index >= count) {
+        printLogDuring("Index of vector out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+
+        return nullptr;
+    }
+
+    BatchView * view = new (std::nothrow) BatchView(coords + index / LANES * dim * LANES + index % LANES, dim, logger);
+
+    if(view == nullptr) {
+        printLogDuring("Not enough memory to create the view", during, RESULT_CODE::OUT_OF_MEMORY, logger);
+    }
+
+    return view;
+}
+
+double const * VectorBatch::getData() const {
+    return coords;
+}
+
+double * VectorBatch::getMutableData() {
+    return coords;
+}
+
+
+
+/* BatchView */
+
+BatchView::BatchView(double * pCoords, size_t dim, ILogger * pLogger) : IVector(), Loggable(pLogger),
+    coords(pCoords), dim(dim) {}
+
+BatchView::~BatchView() {
+    coords = nullptr;
+}
+
+IVector * BatchView::clone() const {
+    return clone(nullptr);
+}
+
+//clones are ordinary contiguous vectors
+IVector * BatchView::clone(IVectorArena * pArena) const {
+    double * data = new (std::nothrow) double[dim];
+
+    if(data == nullptr) {
+        printLogDuring("Not enough memory to create the vector", "IVector::clone", RESULT_CODE::OUT_OF_MEMORY, logger);
+
+        return nullptr;
+    }
+
+    for(size_t i = 0; i < dim; ++i) {
+        data[i] = coords[i * STRIDE];
+    }
+
+    IVector * vec = IVector::createTrustedVector(dim, data, logger, pArena);
+
+    delete [] data;
+    data = nullptr;
+
+    return vec;
+}
+
+double BatchView::getCoord(size_t index) const {
+    char const * during = "IVector::getCoord";
+
+    if(index >= dim) {
+        printLogDuring("Index of vector in set out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    return coords[index * STRIDE];
+}
+
+RESULT_CODE BatchView::setCoord(size_t index, double value) {
+    char const * during = "IVector::setCoord";
+
+    if(index >= dim) {
+        return printLogDuring("Error in setting coord index", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+    }
+
+    if(std::isnan(value)) {
+        return printLogDuring("Coord value is equal to NaN", during, RESULT_CODE::NAN_VALUE, logger);
+    }
+
+    coords[index * STRIDE] = value;
+
+    return RESULT_CODE::SUCCESS;
+}
+
+double BatchView::norm(NORM norm) const {
+    char const * during = "IVector::norm";
+    double result = 0.;
+
+    switch(norm) {
+    case NORM::NORM_1:
+        for(size_t i = 0; i < dim; ++i) {
+            result += std::fabs(coords[i * STRIDE]);
+        }
+
+        return result;
+
+    case NORM::NORM_2:
+        for(size_t i = 0; i < dim; ++i) {
+            result += coords[i * STRIDE] * coords[i * STRIDE];
+        }
+
+        return std::sqrt(result);
+
+    case NORM::NORM_INF:
+        for(size_t i = 0; i < dim; ++i) {
+            result = std::max(result, std::fabs(coords[i * STRIDE]));
+        }
+
+        return result;
+    }
+
+    printLogDuring("Invalid value of norm", during, RESULT_CODE::WRONG_ARGUMENT, logger);
+
+    return std::numeric_limits <double>::quiet_NaN();
+}
+
+size_t BatchView::getDim() const {
+    return dim;
+}
+
+//coordinates are not contiguous
+double const * BatchView::getData() const {
+    return nullptr;
+}
+
+double * BatchView::getMutableData() {
+    return nullptr;
+}
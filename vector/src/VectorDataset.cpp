@@ -0,0 +1,541 @@
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <new>
+
+#ifdef _WIN32
+//std::min and std::max are used below, windows.h would define them as macros otherwise
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "../include/IVectorDataset.h"
+#include "Loggable.h"
+
+
+
+namespace {
+char const MAGIC[8] = {'I', 'V', 'E', 'C', 'D', 'S', '0', '1'};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t scalarType;
+    uint32_t alignment;
+    uint64_t dim;
+    uint64_t count;
+    uint64_t dataOffset;
+    uint8_t reserved[24];
+};
+
+static_assert(sizeof(FileHeader) == 64, "Dataset header must take 64 bytes");
+
+/* Read-only mapping of a whole file */
+struct FileMapping {
+    void const * data;
+    size_t size;
+};
+
+class VectorDataset : public IVectorDataset, private Loggable {
+public:
+    ~VectorDataset() override;
+    size_t getCount() const override;
+    size_t getDim() const override;
+    SCALAR getScalarType() const override;
+    IVector * createVector(size_t index) const override;
+    IVectorBatch * createBatch(size_t first, size_t count) const override;
+    void const * getData() const override;
+
+    static VectorDataset * open(char const * pPath, ILogger * pLogger);
+
+private:
+    VectorDataset(FileMapping const & mapping, FileHeader const & header, ILogger * pLogger);
+    VectorDataset(VectorDataset const & anotherDataset) = delete;
+    VectorDataset & operator = (VectorDataset const & anotherDataset) = delete;
+
+    FileMapping mapping;
+    size_t count;
+    size_t dim;
+    SCALAR type;
+    void const * rows;
+};
+
+class VectorDatasetWriter : public IVectorDatasetWriter, private Loggable {
+public:
+    ~VectorDatasetWriter() override;
+    RESULT_CODE append(IVector const * pVector) override;
+    RESULT_CODE append(double const * pData) override;
+    size_t getCount() const override;
+    RESULT_CODE close() override;
+
+    static VectorDatasetWriter * create(char const * pPath, size_t dim, IVectorDataset::SCALAR type, size_t alignment,
+                                        ILogger * pLogger);
+
+private:
+    VectorDatasetWriter(FILE * pFile, FileHeader const & header, ILogger * pLogger);
+    VectorDatasetWriter(VectorDatasetWriter const & anotherWriter) = delete;
+    VectorDatasetWriter & operator = (VectorDatasetWriter const & anotherWriter) = delete;
+
+    FILE * file;
+    //a row was written partly, the file was closed with the rows before it
+    bool failed;
+    FileHeader header;
+    //one row converted before it is written
+    std::vector <double> row;
+    std::vector <float> floatRow;
+};
+}
+
+
+
+/* Secondary functions */
+
+namespace {
+size_t scalarSize(IVectorDataset::SCALAR type) {
+    return type == IVectorDataset::SCALAR::DOUBLE ? sizeof(double) : sizeof(float);
+}
+
+#ifdef _WIN32
+bool mapFile(char const * pPath, FileMapping & mapping) {
+    HANDLE file = CreateFileA(pPath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+
+    if(file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+
+    if(!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG) sizeof(FileHeader) ||
+            (uint64_t) size.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+
+        return false;
+    }
+
+    HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    CloseHandle(file);
+
+    if(fileMapping == nullptr) {
+        return false;
+    }
+
+    //the view keeps the mapping alive
+    mapping.data = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    mapping.size = (size_t) size.QuadPart;
+
+    CloseHandle(fileMapping);
+
+    return mapping.data != nullptr;
+}
+
+void unmapFile(FileMapping const & mapping) {
+    UnmapViewOfFile(mapping.data);
+}
+#else
+bool mapFile(char const * pPath, FileMapping & mapping) {
+    int file = ::open(pPath, O_RDONLY);
+
+    if(file < 0) {
+        return false;
+    }
+
+    struct stat status;
+
+    if(fstat(file, &status) != 0 || status.st_size < (off_t) sizeof(FileHeader) ||
+            (uint64_t) status.st_size > SIZE_MAX) {
+        ::close(file);
+
+        return false;
+    }
+
+    void * data = mmap(nullptr, (size_t) status.st_size, PROT_READ, MAP_SHARED, file, 0);
+
+    //the mapping keeps the file open
+    ::close(file);
+
+    if(data == MAP_FAILED) {
+        return false;
+    }
+
+    mapping.data = data;
+    mapping.size = (size_t) status.st_size;
+
+    return true;
+}
+
+void unmapFile(FileMapping const & mapping) {
+    munmap(const_cast <void *> (mapping.data), mapping.size);
+}
+#endif
+
+/* everything the reader relies on: rows fit into the file and start aligned */
+bool validHeader(FileHeader const & header, size_t fileSize) {
+    if(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.scalarType > 1 || header.dim == 0) {
+        return false;
+    }
+
+    if(header.alignment < 8 || (header.alignment & (header.alignment - 1)) != 0 ||
+            header.dataOffset % header.alignment != 0 || header.dataOffset < sizeof(FileHeader) ||
+            header.dataOffset > fileSize) {
+        return false;
+    }
+
+    size_t size = scalarSize((IVectorDataset::SCALAR) header.scalarType);
+
+    if(header.dim > SIZE_MAX / size) {
+        return false;
+    }
+
+    return header.count <= (fileSize - header.dataOffset) / (header.dim * size);
+}
+}
+
+
+
+/* IVectorDataset */
+
+IVectorDataset::~IVectorDataset() = default;
+
+IVectorDataset * IVectorDataset::open(char const * pPath, ILogger * pLogger) {
+    return VectorDataset::open(pPath, pLogger);
+}
+
+
+/* IVectorDatasetWriter */
+
+IVectorDatasetWriter::~IVectorDatasetWriter() = default;
+
+IVectorDatasetWriter * IVectorDatasetWriter::create(char const * pPath, size_t dim, IVectorDataset::SCALAR type,
+                                                    size_t alignment, ILogger * pLogger) {
+    return VectorDatasetWriter::create(pPath, dim, type, alignment, pLogger);
+}
+
+
+/* VectorDataset */
+
+VectorDataset::VectorDataset(FileMapping const & mapping, FileHeader const & header, ILogger * pLogger) :
+    IVectorDataset(), Loggable(pLogger), mapping(mapping), count((size_t) header.count), dim((size_t) header.dim),
+    type((SCALAR) header.scalarType), rows((char const *) mapping.data + header.dataOffset) {}
+
+VectorDataset::~VectorDataset() {
+    unmapFile(mapping);
+}
+
+VectorDataset * VectorDataset::open(char const * pPath, ILogger * pLogger) {
+    char const * during = "IVectorDataset::open";
+
+    if(pPath == nullptr) {
+        printLogDuring("Path turned out to be equal to nullptr", during, RESULT_CODE::BAD_REFERENCE, pLogger);
+
+        return nullptr;
+    }
+
+    FileMapping mapping;
+
+    if(!mapFile(pPath, mapping)) {
+        printLogDuring("Failed to map the dataset file", during, RESULT_CODE::FILE_ERROR, pLogger);
+
+        return nullptr;
+    }
+
+    FileHeader header;
+
+    std::memcpy(&header, mapping.data, sizeof(header));
+
+    if(!validHeader(header, mapping.size)) {
+        printLogDuring("Dataset header is corrupted or does not match the file size", during, RESULT_CODE::FILE_ERROR,
+                       pLogger);
+        unmapFile(mapping);
+
+        return nullptr;
+    }
+
+    VectorDataset * dataset = new (std::nothrow) VectorDataset(mapping, header, pLogger);
+
+    if(dataset == nullptr) {
+        printLogDuring("Not enough memory to create the dataset", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+        unmapFile(mapping);
+    }
+
+    return dataset;
+}
+
+size_t VectorDataset::getCount() const {
+    return count;
+}
+
+size_t VectorDataset::getDim() const {
+    return dim;
+}
+
+IVectorDataset::SCALAR VectorDataset::getScalarType() const {
+    return type;
+}
+
+IVector * VectorDataset::createVector(size_t index) const {
+    char const * during = "IVectorDataset::createVector";
+
+    if(index >= count) {
+        printLogDuring("Index of vector in dataset out of bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+
+        return nullptr;
+    }
+
+    if(type == SCALAR::DOUBLE) {
+        double const * row = (double const *) rows + index * dim;
+
+        //the file may come from anywhere, the view does not check the coordinates itself
+        if(IVector::hasNaN(row, dim)) {
+            printLogDuring("NaN vector component was found in the dataset", during, RESULT_CODE::NAN_VALUE, logger);
+
+            return nullptr;
+        }
+
+        return IVector::createReadOnlyView(dim, row, logger);
+    }
+
+    return IVector::createFloatVector(dim, (float const *) rows + index * dim, logger);
+}
+
+IVectorBatch * VectorDataset::createBatch(size_t first, size_t batchCount) const {
+    char const * during = "IVectorDataset::createBatch";
+    size_t const LANES = IVectorBatch::LANES;
+
+    if(first > count || batchCount > count - first) {
+        printLogDuring("Rows of the batch are out of the dataset bounds", during, RESULT_CODE::OUT_OF_BOUNDS, logger);
+
+        return nullptr;
+    }
+
+    IVectorBatch * batch = IVectorBatch::createBatch(batchCount, dim, logger);
+
+    if(batch == nullptr) {
+        return nullptr;
+    }
+
+    double * coords = batch->getMutableData();
+    bool nanFound = false;
+
+    for(size_t i = 0; i < batchCount && !nanFound; ++i) {
+        double * block = coords + (i / LANES * dim) * LANES + i % LANES;
+
+        if(type == SCALAR::DOUBLE) {
+            double const * row = (double const *) rows + (first + i) * dim;
+
+            nanFound = IVector::hasNaN(row, dim);
+
+            for(size_t j = 0; j < dim && !nanFound; ++j) {
+                block[j * LANES] = row[j];
+            }
+        } else {
+            float const * row = (float const *) rows + (first + i) * dim;
+
+            for(size_t j = 0; j < dim; ++j) {
+                block[j * LANES] = row[j];
+                nanFound |= std::isnan(row[j]);
+            }
+        }
+    }
+
+    if(nanFound) {
+        printLogDuring("NaN vector component was found in the dataset", during, RESULT_CODE::NAN_VALUE, logger);
+
+        delete batch;
+        batch = nullptr;
+    }
+
+    return batch;
+}
+
+void const * VectorDataset::getData() const {
+    return rows;
+}
+
+
+/* VectorDatasetWriter */
+
+VectorDatasetWriter::VectorDatasetWriter(FILE * pFile, FileHeader const & header, ILogger * pLogger) :
+    IVectorDatasetWriter(), Loggable(pLogger), file(pFile), failed(false), header(header) {}
+
+VectorDatasetWriter::~VectorDatasetWriter() {
+    close();
+}
+
+VectorDatasetWriter * VectorDatasetWriter::create(char const * pPath, size_t dim, IVectorDataset::SCALAR type,
+                                                  size_t alignment, ILogger * pLogger) {
+    char const * during = "IVectorDatasetWriter::create";
+
+    if(pPath == nullptr) {
+        printLogDuring("Path turned out to be equal to nullptr", during, RESULT_CODE::BAD_REFERENCE, pLogger);
+
+        return nullptr;
+    }
+
+    if(dim == 0) {
+        printLogDuring("Trying to create a dataset of zero-dimensional vectors", during, RESULT_CODE::WRONG_DIM,
+                       pLogger);
+
+        return nullptr;
+    }
+
+    if(alignment < 8 || (alignment & (alignment - 1)) != 0 ||
+            (type != IVectorDataset::SCALAR::DOUBLE && type != IVectorDataset::SCALAR::FLOAT)) {
+        printLogDuring("Alignment is not a power of two not less than 8 or the scalar type is invalid", during,
+                       RESULT_CODE::WRONG_ARGUMENT, pLogger);
+
+        return nullptr;
+    }
+
+    FileHeader header = FileHeader();
+
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.scalarType = (uint32_t) type;
+    header.alignment = (uint32_t) alignment;
+    header.dim = dim;
+    header.dataOffset = std::max(sizeof(FileHeader), alignment);
+
+    FILE * file = std::fopen(pPath, "wb");
+
+    if(file == nullptr) {
+        printLogDuring("Failed to create the dataset file", during, RESULT_CODE::FILE_ERROR, pLogger);
+
+        return nullptr;
+    }
+
+    VectorDatasetWriter * writer = new (std::nothrow) VectorDatasetWriter(file, header, pLogger);
+
+    if(writer == nullptr) {
+        printLogDuring("Not enough memory to create the writer", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+        std::fclose(file);
+
+        return nullptr;
+    }
+
+    //the count is rewritten on close, the gap up to the rows is zero
+    std::vector <char> zeros;
+
+    try {
+        zeros.resize(header.dataOffset - sizeof(FileHeader));
+        writer->row.resize(dim);
+        writer->floatRow.resize(type == IVectorDataset::SCALAR::FLOAT ? dim : 0);
+    } catch(std::bad_alloc const &) {
+        printLogDuring("Not enough memory to create the writer", during, RESULT_CODE::OUT_OF_MEMORY, pLogger);
+
+        delete writer;
+        writer = nullptr;
+
+        return nullptr;
+    }
+
+    if(std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+            (!zeros.empty() && std::fwrite(zeros.data(), 1, zeros.size(), file) != zeros.size())) {
+        printLogDuring("Failed to write the dataset header", during, RESULT_CODE::FILE_ERROR, pLogger);
+
+        delete writer;
+        writer = nullptr;
+    }
+
+    return writer;
+}
+
+RESULT_CODE VectorDatasetWriter::append(IVector const * pVector) {
+    char const * during = "IVectorDatasetWriter::append";
+
+    if(pVector == nullptr) {
+        return printLogDuring("Vector turned out to be equal to nullptr", during, RESULT_CODE::BAD_REFERENCE, logger);
+    }
+
+    if(pVector->getDim() != header.dim) {
+        return printLogDuring("The dimension of the vector does not match the dataset", during, RESULT_CODE::WRONG_DIM,
+                              logger);
+    }
+
+    double const * data = pVector->getData();
+
+    if(data == nullptr) {
+        for(size_t i = 0; i < row.size(); ++i) {
+            row[i] = pVector->getCoord(i);
+        }
+
+        data = row.data();
+    }
+
+    return append(data);
+}
+
+RESULT_CODE VectorDatasetWriter::append(double const * pData) {
+    char const * during = "IVectorDatasetWriter::append";
+
+    if(file == nullptr) {
+        return printLogDuring(failed ? "The writer was closed after a failed write" : "The writer is already closed",
+                              during, RESULT_CODE::FILE_ERROR, logger);
+    }
+
+    if(pData == nullptr) {
+        return printLogDuring("Data turned out to be equal to nullptr", during, RESULT_CODE::BAD_REFERENCE, logger);
+    }
+
+    if(IVector::hasNaN(pData, row.size())) {
+        return printLogDuring("NaN vector component was found", during, RESULT_CODE::NAN_VALUE, logger);
+    }
+
+    size_t written;
+
+    if(floatRow.empty()) {
+        written = std::fwrite(pData, sizeof(double), row.size(), file);
+    } else {
+        for(size_t i = 0; i < floatRow.size(); ++i) {
+            floatRow[i] = (float) pData[i];
+        }
+
+        written = std::fwrite(floatRow.data(), sizeof(float), floatRow.size(), file);
+    }
+
+    //the file position has moved by the part written, so later rows would be shifted; the rows before are kept
+    if(written != row.size()) {
+        close();
+        failed = true;
+
+        return printLogDuring("Failed to write the row, the writer is closed", during, RESULT_CODE::FILE_ERROR,
+                              logger);
+    }
+
+    ++header.count;
+
+    return RESULT_CODE::SUCCESS;
+}
+
+size_t VectorDatasetWriter::getCount() const {
+    return (size_t) header.count;
+}
+
+RESULT_CODE VectorDatasetWriter::close() {
+    char const * during = "IVectorDatasetWriter::close";
+
+    if(file == nullptr) {
+        return failed ? printLogDuring("The writer was closed after a failed write", during, RESULT_CODE::FILE_ERROR,
+                                       logger) : RESULT_CODE::SUCCESS;
+    }
+
+    bool written = std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+    written &= std::fclose(file) == 0;
+    file = nullptr;
+
+    if(!written) {
+        return printLogDuring("Failed to write the dataset header", during, RESULT_CODE::FILE_ERROR, logger);
+    }
+
+    return RESULT_CODE::SUCCESS;
+}
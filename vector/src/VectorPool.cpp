@@ -0,0 +1,282 @@
+#include <mem.h>
+#include <vector>
+#include <new>
+#include <stdint.h>
+#include <cmath>
+
+#include "../include/IVectorPool.h"
+#include "Loggable.h"
+
+
+
+namespace {
+class VectorPool : public IVectorPool, private Loggable {
+public:
+    ~VectorPool() override;
+    IVector const * intern(IVector const * pVector) override;
+    IVector const * intern(size_t dim, double const * pData) override;
+    size_t getCount() const override;
+    void clear() override;
+
+    static VectorPool * createPool(ILogger * pLogger);
+
+private:
+    VectorPool(ILogger * pLogger);
+    VectorPool(VectorPool const & anotherPool) = delete;
+    VectorPool & operator = (VectorPool const & anotherPool) = delete;
+
+    struct Slot {
+        uint64_t hash;
+        //nullptr for an empty slot
+        IVector * vector;
+    };
+
+    //pData itself, or its copy in the buffer with -0.0 replaced by 0.0 if it has any; nullptr if there is no memory
+    double const * canonical(size_t dim, double const * pData, char const * during);
+    //coordinates are known to have no NaN and no -0.0
+    IVector const * find(size_t dim, double const * pData, char const * during);
+    //keeps at least half of the slots empty
+    bool grow();
+
+    static size_t const INITIAL_SLOTS = 64;
+
+    //open addressing with linear probing, the size is a power of two
+    std::vector <Slot> slots;
+    size_t count;
+    std::vector <double> buffer;
+};
+
+
+/* Secondary functions */
+
+/* 64 bits of the coordinates at a time, four independent lanes keep the multiplications pipelined */
+uint64_t hashCoords(double const * coords, size_t dim) {
+    uint64_t const PRIME = 0x9E3779B97F4A7C15ull;
+    uint64_t lanes[4] = {dim, dim + 1, dim + 2, dim + 3};
+    size_t j = 0;
+
+    for(; j + 4 <= dim; j += 4) {
+        for(size_t lane = 0; lane < 4; ++lane) {
+            uint64_t bits;
+
+            memcpy(&bits, coords + j + lane, sizeof(bits));
+            lanes[lane] = (lanes[lane] ^ bits) * PRIME;
+            lanes[lane] ^= lanes[lane] >> 29;
+        }
+    }
+
+    for(; j < dim; ++j) {
+        uint64_t bits;
+
+        memcpy(&bits, coords + j, sizeof(bits));
+        lanes[j % 4] = (lanes[j % 4] ^ bits) * PRIME;
+        lanes[j % 4] ^= lanes[j % 4] >> 29;
+    }
+
+    uint64_t hash = 0;
+
+    for(uint64_t lane : lanes) {
+        hash = (hash ^ lane) * PRIME;
+        hash ^= hash >> 32;
+    }
+
+    return hash;
+}
+}
+
+
+
+/* IVectorPool */
+
+IVectorPool::~IVectorPool() = default;
+
+IVectorPool * IVectorPool::createPool(ILogger * pLogger) {
+    return VectorPool::createPool(pLogger);
+}
+
+
+
+/* VectorPool */
+
+VectorPool::VectorPool(ILogger * pLogger) : IVectorPool(), Loggable(pLogger), count(0) {}
+
+VectorPool::~VectorPool() {
+    clear();
+}
+
+VectorPool * VectorPool::createPool(ILogger * pLogger) {
+    VectorPool * pool = new (std::nothrow) VectorPool(pLogger);
+
+    if(pool == nullptr) {
+        printLogDuring("Not enough memory to create the pool", "IVectorPool::createPool", RESULT_CODE::OUT_OF_MEMORY,
+                       pLogger);
+    }
+
+    return pool;
+}
+
+IVector const * VectorPool::intern(IVector const * pVector) {
+    char const * during = "IVectorPool::intern";
+
+    if(pVector == nullptr) {
+        printLogDuring("Vector turned out to be equal to nullptr", during, RESULT_CODE::BAD_REFERENCE, logger);
+
+        return nullptr;
+    }
+
+    size_t dim = pVector->getDim();
+    double const * data = pVector->getData();
+
+    //single precision and sparse vectors are interned by their double coordinates
+    if(data == nullptr) {
+        try {
+            buffer.resize(dim);
+        } catch(std::bad_alloc const &) {
+            printLogDuring("Not enough memory to read the coordinates", during, RESULT_CODE::OUT_OF_MEMORY, logger);
+
+            return nullptr;
+        }
+
+        for(size_t j = 0; j < dim; ++j) {
+            buffer[j] = pVector->getCoord(j);
+        }
+
+        data = buffer.data();
+    }
+
+    //the table compares bytes, so NaN must not get there through any vector
+    if(IVector::hasNaN(data, dim)) {
+        printLogDuring("Trying to intern a vector with NaN coordinate", during, RESULT_CODE::NAN_VALUE, logger);
+
+        return nullptr;
+    }
+
+    data = canonical(dim, data, during);
+
+    return data == nullptr ? nullptr : find(dim, data, during);
+}
+
+IVector const * VectorPool::intern(size_t dim, double const * pData) {
+    char const * during = "IVectorPool::intern";
+
+    if(dim == 0) {
+        printLogDuring("Trying to intern a zero-dimensional vector", during, RESULT_CODE::WRONG_DIM, logger);
+
+        return nullptr;
+    }
+
+    if(pData == nullptr) {
+        printLogDuring("Trying to intern a vector with nullptr coordinates array", during, RESULT_CODE::BAD_REFERENCE,
+                       logger);
+
+        return nullptr;
+    }
+
+    if(IVector::hasNaN(pData, dim)) {
+        printLogDuring("Trying to intern a vector with NaN coordinate", during, RESULT_CODE::NAN_VALUE, logger);
+
+        return nullptr;
+    }
+
+    double const * data = canonical(dim, pData, during);
+
+    return data == nullptr ? nullptr : find(dim, data, during);
+}
+
+double const * VectorPool::canonical(size_t dim, double const * pData, char const * during) {
+    //-0.0 equals 0.0 but differs in bytes, so one of them is stored for both
+    bool negativeZero = false;
+
+    for(size_t j = 0; j < dim; ++j) {
+        negativeZero |= pData[j] == 0. && std::signbit(pData[j]);
+    }
+
+    if(!negativeZero) {
+        return pData;
+    }
+
+    try {
+        buffer.resize(dim);
+    } catch(std::bad_alloc const &) {
+        printLogDuring("Not enough memory to read the coordinates", during, RESULT_CODE::OUT_OF_MEMORY, logger);
+
+        return nullptr;
+    }
+
+    //the buffer may hold pData already, it keeps its place then
+    for(size_t j = 0; j < dim; ++j) {
+        buffer[j] = pData[j] == 0. ? 0. : pData[j];
+    }
+
+    return buffer.data();
+}
+
+IVector const * VectorPool::find(size_t dim, double const * pData, char const * during) {
+    uint64_t hash = hashCoords(pData, dim);
+    size_t i = 0;
+
+    if((count + 1) * 2 > slots.size() && !grow()) {
+        printLogDuring("Not enough memory to grow the pool", during, RESULT_CODE::OUT_OF_MEMORY, logger);
+
+        return nullptr;
+    }
+
+    for(i = hash & (slots.size() - 1); slots[i].vector != nullptr; i = (i + 1) & (slots.size() - 1)) {
+        IVector const * vector = slots[i].vector;
+
+        if(slots[i].hash == hash && vector->getDim() == dim &&
+           memcmp(vector->getData(), pData, dim * sizeof(double)) == 0) {
+            return vector;
+        }
+    }
+
+    IVector * vector = IVector::createTrustedVector(dim, pData, logger);
+
+    if(vector != nullptr) {
+        slots[i].hash = hash;
+        slots[i].vector = vector;
+        ++count;
+    }
+
+    return vector;
+}
+
+bool VectorPool::grow() {
+    std::vector <Slot> larger;
+
+    try {
+        larger.resize(slots.empty() ? INITIAL_SLOTS : 2 * slots.size(), Slot {0, nullptr});
+    } catch(std::bad_alloc const &) {
+        return false;
+    }
+
+    for(Slot const & slot : slots) {
+        if(slot.vector != nullptr) {
+            size_t i = slot.hash & (larger.size() - 1);
+
+            while(larger[i].vector != nullptr) {
+                i = (i + 1) & (larger.size() - 1);
+            }
+
+            larger[i] = slot;
+        }
+    }
+
+    slots.swap(larger);
+
+    return true;
+}
+
+size_t VectorPool::getCount() const {
+    return count;
+}
+
+void VectorPool::clear() {
+    for(Slot & slot : slots) {
+        delete slot.vector;
+        slot.vector = nullptr;
+    }
+
+    slots.clear();
+    count = 0;
+}
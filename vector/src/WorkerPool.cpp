@@ -0,0 +1,118 @@
+#include "WorkerPool.h"
+
+
+
+/* WorkerPool */
+
+WorkerPool::WorkerPool() : task(nullptr), count(0), next(0), generation(0), active(0), stopping(false) {
+    size_t workersCount = std::thread::hardware_concurrency();
+
+    for(size_t i = 1; i < workersCount; ++i) {
+        try {
+            threads.emplace_back(&WorkerPool::work, this);
+        } catch(...) {
+            //fewer workers, the calling thread still takes its share
+            break;
+        }
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    //a run still in progress finishes first, later ones find no workers and stay on the calling thread
+    std::lock_guard <std::mutex> runLock(running);
+
+    {
+        std::lock_guard <std::mutex> lock(mutex);
+
+        stopping = true;
+    }
+
+    wake.notify_all();
+
+    for(auto & thread : threads) {
+        thread.join();
+    }
+
+    threads.clear();
+}
+
+WorkerPool & WorkerPool::get() {
+    //destroyed with the other statics of the library, so no worker runs its code after it is unloaded
+    static WorkerPool pool;
+
+    return pool;
+}
+
+size_t WorkerPool::getThreadsCount() const {
+    return threads.size() + 1;
+}
+
+void WorkerPool::run(size_t count, std::function <void(size_t)> const & task) {
+    std::unique_lock <std::mutex> runLock(running, std::try_to_lock);
+
+    if(!runLock.owns_lock() || threads.empty()) {
+        for(size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+
+        return;
+    }
+
+    {
+        std::lock_guard <std::mutex> lock(mutex);
+
+        this->task = &task;
+        this->count = count;
+        next = 0;
+        ++generation;
+    }
+
+    wake.notify_all();
+    runTasks(task, count);
+
+    //workers still holding the job must leave before it goes out of scope
+    std::unique_lock <std::mutex> lock(mutex);
+
+    done.wait(lock, [this]() { return active == 0; });
+    this->task = nullptr;
+}
+
+void WorkerPool::runTasks(std::function <void(size_t)> const & task, size_t count) {
+    for(size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+        task(i);
+    }
+}
+
+void WorkerPool::work() {
+    size_t seen = 0;
+
+    while(true) {
+        std::function <void(size_t)> const * job;
+        size_t jobCount;
+
+        {
+            std::unique_lock <std::mutex> lock(mutex);
+
+            wake.wait(lock, [this, seen]() { return stopping || (generation != seen && task != nullptr); });
+
+            if(stopping) {
+                return;
+            }
+
+            seen = generation;
+            job = task;
+            jobCount = count;
+            ++active;
+        }
+
+        runTasks(*job, jobCount);
+
+        {
+            std::lock_guard <std::mutex> lock(mutex);
+
+            --active;
+        }
+
+        done.notify_all();
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+/* Threads shared by the parallel kernels, started on first use and joined when the library unloads */
+class WorkerPool {
+public:
+    static WorkerPool & get();
+
+    //workers and the calling thread
+    size_t getThreadsCount() const;
+    //task(i) for every i in [0, count) on the workers and the calling thread, returns when all are done;
+    //a call made while another one runs does all its tasks on the calling thread
+    void run(size_t count, std::function <void(size_t)> const & task);
+
+private:
+    WorkerPool();
+    ~WorkerPool();
+    WorkerPool(WorkerPool const & anotherPool) = delete;
+    WorkerPool & operator = (WorkerPool const & anotherPool) = delete;
+
+    void work();
+    void runTasks(std::function <void(size_t)> const & task, size_t count);
+
+    std::vector <std::thread> threads;
+    std::mutex running;
+
+    //the job, changed under mutex only while no worker is active
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::function <void(size_t)> const * task;
+    size_t count;
+    std::atomic <size_t> next;
+    size_t generation;
+    size_t active;
+    bool stopping;
+};
+
+#endif // WORKERPOOL_H
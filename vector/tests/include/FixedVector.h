@@ -0,0 +1,269 @@
+#ifndef FIXEDVECTOR_H
+#define FIXEDVECTOR_H
+
+#include <stddef.h>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+#include "IVector.h"
+
+
+
+/* Loops over a compile-time dimension, expanded by the compiler into straight-line code */
+template <size_t I, size_t N>
+struct FixedUnroll {
+    template <typename Function>
+    static void apply(Function function) {
+        function(I);
+        FixedUnroll <I + 1, N>::apply(function);
+    }
+};
+
+template <size_t N>
+struct FixedUnroll <N, N> {
+    template <typename Function>
+    static void apply(Function) {}
+};
+
+
+
+template <size_t N>
+class FixedVectorAdapter;
+
+/* Value-type vector of a compile-time dimension, coordinates are stored by value and never allocated.
+   setCoord rejects NaN as IVector::setCoord does, arithmetic follows IEEE rules and may still obtain it,
+   so the adapter checks the coordinates before handing them to IVector functions */
+template <size_t N>
+class FixedVector {
+    static_assert(N > 0, "FixedVector of zero dimension");
+
+public:
+    FixedVector() : coords() {}
+
+    explicit FixedVector(double const (& data)[N]) {
+        FixedUnroll <0, N>::apply([&](size_t i) { coords[i] = data[i]; });
+    }
+
+    static constexpr size_t getDim() {
+        return N;
+    }
+
+    double operator [] (size_t index) const {
+        return coords[index];
+    }
+
+    RESULT_CODE setCoord(size_t index, double value) {
+        if(index >= N) {
+            return RESULT_CODE::OUT_OF_BOUNDS;
+        }
+
+        if(std::isnan(value)) {
+            return RESULT_CODE::NAN_VALUE;
+        }
+
+        coords[index] = value;
+
+        return RESULT_CODE::SUCCESS;
+    }
+
+    double const * getData() const {
+        return coords;
+    }
+
+    FixedVector & operator += (FixedVector const & operand) {
+        FixedUnroll <0, N>::apply([&](size_t i) { coords[i] += operand.coords[i]; });
+
+        return *this;
+    }
+
+    FixedVector & operator -= (FixedVector const & operand) {
+        FixedUnroll <0, N>::apply([&](size_t i) { coords[i] -= operand.coords[i]; });
+
+        return *this;
+    }
+
+    FixedVector & operator *= (double scaleParam) {
+        FixedUnroll <0, N>::apply([&](size_t i) { coords[i] *= scaleParam; });
+
+        return *this;
+    }
+
+    friend FixedVector operator + (FixedVector operand1, FixedVector const & operand2) {
+        return operand1 += operand2;
+    }
+
+    friend FixedVector operator - (FixedVector operand1, FixedVector const & operand2) {
+        return operand1 -= operand2;
+    }
+
+    friend FixedVector operator * (FixedVector operand1, double scaleParam) {
+        return operand1 *= scaleParam;
+    }
+
+    friend FixedVector operator * (double scaleParam, FixedVector operand1) {
+        return operand1 *= scaleParam;
+    }
+
+    static double dot(FixedVector const & operand1, FixedVector const & operand2) {
+        double result = 0.;
+
+        FixedUnroll <0, N>::apply([&](size_t i) { result += operand1.coords[i] * operand2.coords[i]; });
+
+        return result;
+    }
+
+    //NaN for an invalid value of norm, as IVector::norm
+    double norm(IVector::NORM norm) const {
+        double result = 0.;
+
+        switch(norm) {
+        case IVector::NORM::NORM_1:
+            FixedUnroll <0, N>::apply([&](size_t i) { result += std::fabs(coords[i]); });
+
+            return result;
+
+        case IVector::NORM::NORM_2:
+            return std::sqrt(dot(*this, *this));
+
+        case IVector::NORM::NORM_INF:
+            FixedUnroll <0, N>::apply([&](size_t i) { result = std::max(result, std::fabs(coords[i])); });
+
+            return result;
+        }
+
+        return std::numeric_limits <double>::quiet_NaN();
+    }
+
+    static double distance(FixedVector const & operand1, FixedVector const & operand2, IVector::NORM norm) {
+        return (operand1 - operand2).norm(norm);
+    }
+
+    bool hasNaN() const {
+        bool result = false;
+
+        FixedUnroll <0, N>::apply([&](size_t i) { result |= std::isnan(coords[i]); });
+
+        return result;
+    }
+
+    //heap copy, nullptr if a coordinate is NaN
+    IVector * toVector(ILogger * pLogger) const {
+        double data[N];
+
+        FixedUnroll <0, N>::apply([&](size_t i) { data[i] = coords[i]; });
+
+        return IVector::createVector(N, data, pLogger);
+    }
+
+    static RESULT_CODE fromVector(IVector const * pVector, FixedVector & result) {
+        if(pVector == nullptr) {
+            return RESULT_CODE::BAD_REFERENCE;
+        }
+
+        if(pVector->getDim() != N) {
+            return RESULT_CODE::WRONG_DIM;
+        }
+
+        double const * data = pVector->getData();
+
+        if(data != nullptr) {
+            FixedUnroll <0, N>::apply([&](size_t i) { result.coords[i] = data[i]; });
+        } else {
+            FixedUnroll <0, N>::apply([&](size_t i) { result.coords[i] = pVector->getCoord(i); });
+        }
+
+        return RESULT_CODE::SUCCESS;
+    }
+
+private:
+    //writes through IVector::getMutableData, which the adapter only allows while no coordinate is NaN
+    friend class FixedVectorAdapter <N>;
+
+    double coords[N];
+};
+
+
+
+/* IVector view of a FixedVector without allocation, so that it can be passed to IVector functions.
+   The adapted vector must outlive the adapter; clones are ordinary heap vectors */
+template <size_t N>
+class FixedVectorAdapter : public IVector {
+public:
+    FixedVectorAdapter(FixedVector <N> & vector, ILogger * pLogger) : vector(vector), logger(pLogger) {}
+
+    ~FixedVectorAdapter() override = default;
+
+    //createVector rejects NaN coordinates itself
+    IVector * clone() const override {
+        return IVector::createVector(N, vector.coords, logger);
+    }
+
+    IVector * clone(IVectorArena * pArena) const override {
+        return IVector::createVector(N, vector.coords, logger, pArena);
+    }
+
+    double getCoord(size_t index) const override {
+        if(index >= N) {
+            log("Index of vector out of bounds during \"FixedVectorAdapter::getCoord\"", RESULT_CODE::OUT_OF_BOUNDS);
+
+            return std::numeric_limits <double>::quiet_NaN();
+        }
+
+        return vector[index];
+    }
+
+    RESULT_CODE setCoord(size_t index, double value) override {
+        if(index >= N) {
+            return log("Error in setting coord index during \"FixedVectorAdapter::setCoord\"",
+                       RESULT_CODE::OUT_OF_BOUNDS);
+        }
+
+        if(std::isnan(value)) {
+            return log("Coord value is equal to NaN during \"FixedVectorAdapter::setCoord\"", RESULT_CODE::NAN_VALUE);
+        }
+
+        return vector.setCoord(index, value);
+    }
+
+    //NaN if a coordinate is, so that the bounds IVector functions take from norms do not hide it
+    double norm(NORM norm) const override {
+        if(vector.hasNaN()) {
+            log("NaN vector component was found during \"FixedVectorAdapter::norm\"", RESULT_CODE::NAN_VALUE);
+
+            return std::numeric_limits <double>::quiet_NaN();
+        }
+
+        return vector.norm(norm);
+    }
+
+    size_t getDim() const override {
+        return N;
+    }
+
+    //nullptr while a coordinate is NaN, IVector functions then read them one by one and report it
+    double const * getData() const override {
+        return vector.hasNaN() ? nullptr : vector.coords;
+    }
+
+    double * getMutableData() override {
+        return vector.hasNaN() ? nullptr : vector.coords;
+    }
+
+private:
+    FixedVectorAdapter(FixedVectorAdapter const & adapter) = delete;
+    FixedVectorAdapter & operator = (FixedVectorAdapter const & adapter) = delete;
+
+    RESULT_CODE log(char const * pMsg, RESULT_CODE err) const {
+        if(logger != nullptr) {
+            logger->log(pMsg, err);
+        }
+
+        return err;
+    }
+
+    FixedVector <N> & vector;
+    ILogger * logger;
+};
+
+#endif // FIXEDVECTOR_H
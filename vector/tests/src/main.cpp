@@ -1,8 +1,18 @@
 #include <iostream>
 #include <cmath>
 #include <limits>
+#include <cstdio>
 
 #include "../include/IVector.h"
+#include "../include/FixedVector.h"
+#include "../include/VectorExpr.h"
+#include "../include/IVectorArena.h"
+#include "../include/IVectorBatch.h"
+#include "../include/IVectorDataset.h"
+#include "../include/IMatrix.h"
+#include "../include/INorm.h"
+#include "../include/IQuantizedBatch.h"
+#include "../include/IVectorPool.h"
 
 using namespace std;
 
@@ -161,6 +171,180 @@ bool testMul() {
     return numbersEqual(mul, correctMul);
 }
 
+bool testAddInPlace() {
+    IVector * sum = v->clone();
+    RESULT_CODE resultCode = IVector::addInPlace(sum, w, logger);
+    double correctSumCoords [] = {-2., -2.};
+    IVector * correctSum = IVector::createVector(DIM, correctSumCoords, logger);
+    bool result = resultCode == RESULT_CODE::SUCCESS && equalVectors(sum, correctSum);
+
+    delete correctSum;
+    delete sum;
+
+    correctSum = nullptr;
+    sum = nullptr;
+
+    return result;
+}
+
+bool testSubInPlace() {
+    IVector * diff = v->clone();
+    RESULT_CODE resultCode = IVector::subInPlace(diff, w, logger);
+    double correctDiffCoords [] = {4., 6.};
+    IVector * correctDiff = IVector::createVector(DIM, correctDiffCoords, logger);
+    bool result = resultCode == RESULT_CODE::SUCCESS && equalVectors(diff, correctDiff);
+
+    delete correctDiff;
+    delete diff;
+
+    correctDiff = nullptr;
+    diff = nullptr;
+
+    return result;
+}
+
+bool testScaleInPlace() {
+    IVector * mul = v->clone();
+    RESULT_CODE resultCode = IVector::scaleInPlace(mul, -1, logger);
+    double correctMulCoords [] = {-1., -2.};
+    IVector * correctMul = IVector::createVector(DIM, correctMulCoords, logger);
+    bool result = resultCode == RESULT_CODE::SUCCESS && equalVectors(mul, correctMul);
+
+    delete correctMul;
+    delete mul;
+
+    correctMul = nullptr;
+    mul = nullptr;
+
+    return result;
+}
+
+bool testAxpy() {
+    IVector * y = v->clone();
+    RESULT_CODE resultCode = IVector::axpy(y, 2., w, logger);
+    double correctCoords [] = {-5., -6.};
+    IVector * correct = IVector::createVector(DIM, correctCoords, logger);
+    bool result = resultCode == RESULT_CODE::SUCCESS && equalVectors(y, correct);
+
+    //the maximum norm of a long result is kept from the write, and must match its coordinates
+    size_t const LONG_DIM = 100;
+    double longCoords[LONG_DIM];
+
+    for(size_t i = 0; i < LONG_DIM; ++i) {
+        longCoords[i] = sin(i * 0.7);
+    }
+
+    IVector * longX = IVector::createVector(LONG_DIM, longCoords, logger);
+    IVector * longY = longX->clone();
+
+    result &= IVector::axpy(longY, -3., longX, logger) == RESULT_CODE::SUCCESS &&
+            IVector::axpy(longY, 1., longX, logger) == RESULT_CODE::SUCCESS;
+
+    IVector * fresh = IVector::createTrustedVector(LONG_DIM, longY->getData(), logger);
+
+    result &= longY->norm(IVector::NORM::NORM_INF) == fresh->norm(IVector::NORM::NORM_INF) &&
+            numbersEqual(longY->norm(IVector::NORM::NORM_INF), longX->norm(IVector::NORM::NORM_INF));
+
+    delete correct;
+    delete y;
+    delete longX;
+    delete longY;
+    delete fresh;
+
+    correct = nullptr;
+    y = nullptr;
+    longX = nullptr;
+    longY = nullptr;
+    fresh = nullptr;
+
+    return result;
+}
+
+bool testInPlaceNaN() {
+    double const INF = numeric_limits <double>::infinity();
+    double xCoords [] = {INF, 1., 2.}, yCoords [] = {-INF, 1., 2.}, resultCoords [] = {5., 5., 5.};
+    float xFloatCoords [] = {(float) INF, 1.f, 2.f}, yFloatCoords [] = {(float) -INF, 1.f, 2.f};
+    IVector * x = IVector::createVector(3, xCoords, logger);
+    IVector * y = IVector::createVector(3, yCoords, logger);
+    IVector * xFloat = IVector::createFloatVector(3, xFloatCoords, logger);
+    IVector * yFloat = IVector::createFloatVector(3, yFloatCoords, logger);
+    IVector * result = IVector::createVector(3, resultCoords, logger);
+    bool passed = IVector::addInPlace(x, y, logger) == RESULT_CODE::CALCULATION_ERROR &&
+            IVector::subInPlace(x, x, logger) == RESULT_CODE::CALCULATION_ERROR &&
+            IVector::scaleInPlace(x, 0., logger) == RESULT_CODE::CALCULATION_ERROR &&
+            IVector::axpy(x, 1., y, logger) == RESULT_CODE::CALCULATION_ERROR &&
+            IVector::add(x, y, result, logger) == RESULT_CODE::CALCULATION_ERROR &&
+            IVector::addInPlace(xFloat, yFloat, logger) == RESULT_CODE::CALCULATION_ERROR;
+
+    //the operands and the result are unchanged
+    for(size_t i = 0; i < 3; ++i) {
+        passed &= x->getCoord(i) == xCoords[i] && y->getCoord(i) == yCoords[i] &&
+                xFloat->getCoord(i) == xFloatCoords[i] && result->getCoord(i) == resultCoords[i];
+    }
+
+    passed &= x->norm(IVector::NORM::NORM_INF) == INF && numbersEqual(result->norm(NORM), sqrt(75.));
+
+    delete x;
+    delete y;
+    delete xFloat;
+    delete yFloat;
+    delete result;
+
+    x = nullptr;
+    y = nullptr;
+    xFloat = nullptr;
+    yFloat = nullptr;
+    result = nullptr;
+
+    return passed;
+}
+
+bool testSubToResult() {
+    IVector * diff = w->clone();
+    RESULT_CODE resultCode = IVector::sub(v, w, diff, logger);
+    double correctDiffCoords [] = {4., 6.};
+    IVector * correctDiff = IVector::createVector(DIM, correctDiffCoords, logger);
+    bool result = resultCode == RESULT_CODE::SUCCESS && equalVectors(diff, correctDiff);
+
+    delete correctDiff;
+    delete diff;
+
+    correctDiff = nullptr;
+    diff = nullptr;
+
+    return result;
+}
+
+bool testAddToResultDim() {
+    double coords [] = {0., 0., 0.};
+    IVector * sum = IVector::createVector(3, coords, logger);
+    RESULT_CODE resultCode = IVector::add(v, w, sum, logger);
+
+    delete sum;
+    sum = nullptr;
+
+    return resultCode == RESULT_CODE::WRONG_DIM;
+}
+
+bool testDistance() {
+    double distance1 = IVector::distance(v, w, IVector::NORM::NORM_1, logger);
+    double distance2 = IVector::distance(v, w, IVector::NORM::NORM_2, logger);
+    double distanceInf = IVector::distance(v, w, IVector::NORM::NORM_INF, logger);
+
+    return numbersEqual(distance1, 10.) && numbersEqual(distance2, sqrt(52.)) && numbersEqual(distanceInf, 6.);
+}
+
+bool testDistanceDim() {
+    double coords [] = {1., 2., 3.};
+    IVector * vector = IVector::createVector(3, coords, logger);
+    double distance = IVector::distance(v, vector, NORM, logger);
+
+    delete vector;
+    vector = nullptr;
+
+    return isnan(distance);
+}
+
 bool testEquals() {
     double coords1 [] = {1., 2.};
     double coords2 [] = {1., 2.};
@@ -181,6 +365,38 @@ bool testNotEquals() {
     return !equalVectors(v, w);
 }
 
+bool testWithinTolerance() {
+    size_t const dim = 100;
+    double coords1 [dim] = {0};
+    double coords2 [dim] = {0};
+
+    coords2[dim - 1] = 0.5;
+    coords2[dim - 2] = 0.5;
+
+    IVector * v1 = IVector::createVector(dim, coords1, logger);
+    IVector * v2 = IVector::createVector(dim, coords2, logger);
+    bool within1 = true, within2 = false, withinInf = false, withinLess = true;
+
+    IVector::withinTolerance(v1, v2, IVector::NORM::NORM_1, 0.99, &within1, logger);
+    IVector::withinTolerance(v1, v2, IVector::NORM::NORM_2, 0.71, &within2, logger);
+    IVector::withinTolerance(v1, v2, IVector::NORM::NORM_INF, 0.5, &withinInf, logger);
+    IVector::withinTolerance(v1, v2, IVector::NORM::NORM_INF, 0.49, &withinLess, logger);
+
+    delete v1;
+    delete v2;
+
+    v1 = nullptr;
+    v2 = nullptr;
+
+    return !within1 && within2 && withinInf && !withinLess;
+}
+
+bool testWithinToleranceNegative() {
+    bool result = false;
+
+    return IVector::withinTolerance(v, w, NORM, -1., &result, logger) == RESULT_CODE::WRONG_ARGUMENT;
+}
+
 bool testClone() {
     IVector * cloned = v->clone();
     bool result = cloned != nullptr;
@@ -191,6 +407,79 @@ bool testClone() {
     return result;
 }
 
+bool testCloneDims() {
+    bool result = true;
+
+    for(size_t dim = 1; dim <= 20; ++dim) {
+        double * coords = new double[dim];
+
+        for(size_t i = 0; i < dim; ++i) {
+            coords[i] = i + 1.;
+        }
+
+        IVector * vector = IVector::createVector(dim, coords, logger);
+        IVector * cloned = vector->clone();
+
+        vector->setCoord(dim - 1, 0.);
+        result &= numbersEqual(cloned->getCoord(dim - 1), dim) && numbersEqual(vector->getCoord(dim - 1), 0.);
+
+        delete [] coords;
+        delete vector;
+        delete cloned;
+
+        coords = nullptr;
+        vector = nullptr;
+        cloned = nullptr;
+    }
+
+    return result;
+}
+
+bool testArena() {
+    IVectorArena * arena = IVectorArena::createArena(1024, logger);
+    double coords [20] = {0};
+    bool result = arena != nullptr;
+
+    for(size_t i = 0; i < 50 && result; ++i) {
+        coords[0] = i;
+
+        IVector * small = IVector::createVector(3, coords, logger, arena);
+        IVector * large = IVector::createVector(20, coords, logger, arena);
+        IVector * cloned = large->clone(arena);
+
+        result = small != nullptr && large != nullptr && cloned != nullptr && numbersEqual(small->getCoord(0), i) &&
+                numbersEqual(cloned->getCoord(0), i);
+
+        delete small;
+        small = nullptr;
+    }
+
+    result &= arena->getUsed() > 0 && arena->getCapacity() >= arena->getUsed();
+    arena->reset();
+    result &= arena->getUsed() == 0;
+
+    IVector * cloned = v->clone(arena);
+    result &= cloned != nullptr && equalVectors(cloned, v);
+
+    delete cloned;
+    delete arena;
+
+    cloned = nullptr;
+    arena = nullptr;
+
+    return result;
+}
+
+bool testArenaChunkSize() {
+    IVectorArena * arena = IVectorArena::createArena(0, logger);
+    bool result = arena == nullptr;
+
+    delete arena;
+    arena = nullptr;
+
+    return result;
+}
+
 bool testGetCoord() {
     double coord = v->getCoord(0);
     double correctCoord = 1.;
@@ -198,6 +487,26 @@ bool testGetCoord() {
     return numbersEqual(coord, correctCoord);
 }
 
+bool testGetData() {
+    double const * data = v->getData();
+
+    return data != nullptr && numbersEqual(data[0], 1.) && numbersEqual(data[1], 2.);
+}
+
+bool testGetMutableData() {
+    IVector * vector = v->clone();
+    double * data = vector->getMutableData();
+
+    data[1] = 5.;
+
+    bool result = numbersEqual(vector->getCoord(1), 5.) && numbersEqual(v->getCoord(1), 2.);
+
+    delete vector;
+    vector = nullptr;
+
+    return result;
+}
+
 bool testGetCoordIndex() {
     return isnan(v->getCoord(DIM));
 }
@@ -256,6 +565,1195 @@ bool testNorm() {
             && numbersEqual(normInf, correctNormInf);
 }
 
+bool testSelfTest() {
+    return IVector::selfTest(logger) == RESULT_CODE::SUCCESS;
+}
+
+bool testNormLarge() {
+    size_t const dim = 1027;
+    double * coords = new double[dim];
+
+    for(size_t i = 0; i < dim; ++i) {
+        coords[i] = i % 2 == 0 ? 1. : -1.;
+    }
+
+    IVector * vector = IVector::createVector(dim, coords, logger);
+    bool result = numbersEqual(vector->norm(IVector::NORM::NORM_1), dim) &&
+            numbersEqual(vector->norm(IVector::NORM::NORM_2), sqrt(dim)) &&
+            numbersEqual(vector->norm(IVector::NORM::NORM_INF), 1.) &&
+            numbersEqual(IVector::mul(vector, vector, logger), dim);
+
+    delete [] coords;
+    delete vector;
+
+    coords = nullptr;
+    vector = nullptr;
+
+    return result;
+}
+
+bool testFloatVector() {
+    size_t const dim = 37;
+    float * floatCoords = new float[dim];
+    double * coords = new double[dim];
+
+    for(size_t i = 0; i < dim; ++i) {
+        floatCoords[i] = i % 3 == 0 ? 0.5f : -1.25f;
+        coords[i] = floatCoords[i];
+    }
+
+    IVector * floatVector = IVector::createFloatVector(dim, floatCoords, logger);
+    IVector * vector = IVector::createVector(dim, coords, logger);
+    IVector * cloned = floatVector->clone();
+    IVector * sum = IVector::add(floatVector, cloned, logger);
+    bool equal = false;
+    bool result = floatVector->getData() == nullptr && floatVector->getMutableData() == nullptr &&
+            numbersEqual(floatVector->norm(IVector::NORM::NORM_1), vector->norm(IVector::NORM::NORM_1)) &&
+            numbersEqual(floatVector->norm(IVector::NORM::NORM_2), vector->norm(IVector::NORM::NORM_2)) &&
+            numbersEqual(floatVector->norm(IVector::NORM::NORM_INF), 1.25) &&
+            numbersEqual(IVector::mul(floatVector, cloned, logger), IVector::mul(vector, vector, logger)) &&
+            numbersEqual(IVector::distance(floatVector, vector, NORM, logger), 0.) &&
+            numbersEqual(sum->getCoord(1), -2.5) &&
+            IVector::withinTolerance(floatVector, cloned, NORM, TOLERANCE, &equal, logger) == RESULT_CODE::SUCCESS &&
+            equal;
+
+    delete [] floatCoords;
+    delete [] coords;
+    delete floatVector;
+    delete vector;
+    delete cloned;
+    delete sum;
+
+    floatCoords = nullptr;
+    coords = nullptr;
+    floatVector = nullptr;
+    vector = nullptr;
+    cloned = nullptr;
+    sum = nullptr;
+
+    return result;
+}
+
+bool testFloatVectorNaN() {
+    float coords [] = {1.f, NAN};
+    IVector * vector = IVector::createFloatVector(2, coords, logger);
+    bool result = vector == nullptr;
+
+    delete vector;
+    vector = nullptr;
+
+    return result;
+}
+
+bool testFixedVector() {
+    double aCoords [] = {1., 2., 2.};
+    double bCoords [] = {-3., 0., 4.};
+    FixedVector <3> a(aCoords), b(bCoords);
+    FixedVector <3> sum = a + b, diff = a - b, scaled = 2. * a;
+
+    return numbersEqual(sum[0], -2.) && numbersEqual(diff[2], -2.) && numbersEqual(scaled[1], 4.) &&
+            numbersEqual(FixedVector <3>::dot(a, b), 5.) && numbersEqual(a.norm(IVector::NORM::NORM_1), 5.) &&
+            numbersEqual(a.norm(IVector::NORM::NORM_2), 3.) && numbersEqual(b.norm(IVector::NORM::NORM_INF), 4.) &&
+            numbersEqual(FixedVector <3>::distance(a, b, IVector::NORM::NORM_INF), 4.);
+}
+
+bool testFixedVectorAdapter() {
+    double coords [] = {1., 2.};
+    FixedVector <2> fixed(coords);
+    FixedVectorAdapter <2> adapter(fixed, logger);
+    IVector * cloned = adapter.clone();
+    FixedVector <2> back;
+    FixedVector <3> wrongDim;
+    bool result = numbersEqual(IVector::distance(&adapter, v, NORM, logger), 0.) &&
+            IVector::addInPlace(&adapter, w, logger) == RESULT_CODE::SUCCESS && numbersEqual(fixed[1], -2.) &&
+            numbersEqual(cloned->getCoord(1), 2.) && adapter.setCoord(2, 0.) == RESULT_CODE::OUT_OF_BOUNDS &&
+            FixedVector <2>::fromVector(w, back) == RESULT_CODE::SUCCESS && numbersEqual(back[0], -3.) &&
+            FixedVector <3>::fromVector(w, wrongDim) == RESULT_CODE::WRONG_DIM;
+
+    //NaN is refused by setCoord, and one obtained by arithmetic is not handed to IVector functions
+    double infinite [] = {std::numeric_limits <double>::infinity(), 0.};
+    FixedVector <2> invalid(infinite);
+    FixedVectorAdapter <2> invalidAdapter(invalid, logger);
+    IVector * invalidClone = nullptr;
+
+    result &= fixed.setCoord(0, std::numeric_limits <double>::quiet_NaN()) == RESULT_CODE::NAN_VALUE &&
+            fixed.setCoord(0, 1.) == RESULT_CODE::SUCCESS && numbersEqual(fixed[0], 1.);
+    invalid -= invalid;
+    invalidClone = invalidAdapter.clone();
+    result &= invalidAdapter.getData() == nullptr && invalidAdapter.getMutableData() == nullptr &&
+            std::isnan(invalidAdapter.norm(NORM)) && invalidClone == nullptr &&
+            IVector::addInPlace(&adapter, &invalidAdapter, logger) == RESULT_CODE::CALCULATION_ERROR &&
+            numbersEqual(fixed[0], 1.);
+
+    delete cloned;
+    delete invalidClone;
+
+    cloned = nullptr;
+    invalidClone = nullptr;
+
+    return result;
+}
+
+bool testView() {
+    double coords [] = {1., 2.};
+    IVector * view = IVector::createView(DIM, coords, logger);
+    IVector * cloned = view->clone();
+    bool result = view->getData() == coords && numbersEqual(IVector::distance(view, v, NORM, logger), 0.) &&
+            view->setCoord(0, 5.) == RESULT_CODE::SUCCESS && numbersEqual(coords[0], 5.) &&
+            numbersEqual(cloned->getCoord(0), 1.) && cloned->getData() != coords;
+
+    delete view;
+    delete cloned;
+
+    view = nullptr;
+    cloned = nullptr;
+
+    return result;
+}
+
+bool testReadOnlyView() {
+    double const coords [] = {1., 2.};
+    IVector * view = IVector::createReadOnlyView(DIM, coords, logger);
+    bool result = view->getMutableData() == nullptr && view->setCoord(0, 5.) != RESULT_CODE::SUCCESS &&
+            IVector::addInPlace(view, w, logger) != RESULT_CODE::SUCCESS && numbersEqual(coords[0], 1.) &&
+            numbersEqual(IVector::mul(view, w, logger), -11.);
+
+    delete view;
+    view = nullptr;
+
+    return result;
+}
+
+bool testVectorExpr() {
+    IVector * result = v->clone();
+    double coords [] = {1., 2.};
+    IVector * view = IVector::createReadOnlyView(DIM, coords, logger);
+    //v + 2 * (w - v) = {-7, -10}
+    bool correct = evaluate(result, vectorExpr(v) + 2. * (vectorExpr(w) - vectorExpr(view)), logger) ==
+            RESULT_CODE::SUCCESS && numbersEqual(result->getCoord(0), -7.) && numbersEqual(result->getCoord(1), -10.);
+
+    //the result may be one of the operands
+    correct &= evaluate(result, vectorExpr(result) * 0.5 - vectorExpr(w), logger) == RESULT_CODE::SUCCESS &&
+            numbersEqual(result->getCoord(0), -0.5) && numbersEqual(result->getCoord(1), -1.);
+
+    correct &= evaluate(view, vectorExpr(v) + vectorExpr(w), logger) == RESULT_CODE::CALCULATION_ERROR;
+
+    delete result;
+    delete view;
+
+    result = nullptr;
+    view = nullptr;
+
+    return correct;
+}
+
+bool testVectorExprInvalid() {
+    double coords [] = {1., 2., 3.};
+    IVector * vector = IVector::createVector(3, coords, logger);
+    IVector * result = v->clone();
+    bool correct = evaluate(result, vectorExpr(v) + vectorExpr(vector), logger) == RESULT_CODE::WRONG_ARGUMENT &&
+            evaluate(result, vectorExpr(nullptr) + vectorExpr(v), logger) == RESULT_CODE::WRONG_ARGUMENT &&
+            evaluate(vector, vectorExpr(v) - vectorExpr(w), logger) == RESULT_CODE::WRONG_DIM &&
+            evaluate(result, NAN * vectorExpr(v), logger) == RESULT_CODE::WRONG_ARGUMENT;
+
+    //inf - inf in the last coordinate, the result is the first operand and stays unchanged
+    vector->setCoord(2, INFINITY);
+    correct &= evaluate(vector, vectorExpr(vector) - vectorExpr(vector), logger) == RESULT_CODE::CALCULATION_ERROR &&
+            vector->getCoord(0) == 1. && vector->getCoord(1) == 2. && vector->getCoord(2) == INFINITY;
+
+    //a separate result is written in one pass and cleared
+    IVector * separate = IVector::createVector(3, coords, logger);
+
+    correct &= evaluate(separate, vectorExpr(vector) - vectorExpr(vector), logger) == RESULT_CODE::CALCULATION_ERROR &&
+            separate->getCoord(0) == 0. && separate->getCoord(2) == 0. &&
+            evaluate(separate, 2. * vectorExpr(vector), logger) == RESULT_CODE::SUCCESS && separate->getCoord(1) == 4.;
+
+    delete vector;
+    delete result;
+    delete separate;
+
+    vector = nullptr;
+    result = nullptr;
+    separate = nullptr;
+
+    return correct;
+}
+
+bool testVectorBatch() {
+    size_t const count = 11, dim = 3;
+    IVectorBatch * batch = IVectorBatch::createBatch(count, dim, logger);
+    double coords [] = {1., -2., 2.};
+    IVector * query = IVector::createVector(dim, coords, logger);
+    double results[count];
+    bool result = true;
+
+    for(size_t i = 0; i < count; ++i) {
+        for(size_t j = 0; j < dim; ++j) {
+            batch->setCoord(i, j, i + j);
+        }
+    }
+
+    IVectorBatch * twice = batch->clone();
+
+    result &= IVectorBatch::add(batch, batch, twice, logger) == RESULT_CODE::SUCCESS &&
+            IVectorBatch::sub(twice, batch, twice, logger) == RESULT_CODE::SUCCESS &&
+            IVectorBatch::mul(twice, 2., twice, logger) == RESULT_CODE::SUCCESS &&
+            numbersEqual(twice->getCoord(10, 2), 24.);
+
+    result &= IVectorBatch::mul(batch, query, results, logger) == RESULT_CODE::SUCCESS;
+
+    for(size_t i = 0; i < count; ++i) {
+        result &= numbersEqual(results[i], i * 1. - (i + 1.) * 2. + (i + 2.) * 2.);
+    }
+
+    for(IVector::NORM norm : {IVector::NORM::NORM_1, IVector::NORM::NORM_2, IVector::NORM::NORM_INF}) {
+        double norms[count];
+
+        result &= IVectorBatch::distance(batch, query, norm, results, logger) == RESULT_CODE::SUCCESS &&
+                IVectorBatch::norm(batch, norm, norms, logger) == RESULT_CODE::SUCCESS;
+
+        for(size_t i = 0; i < count; ++i) {
+            IVector * view = batch->createView(i);
+
+            result &= numbersEqual(results[i], IVector::distance(view, query, norm, logger)) &&
+                    numbersEqual(norms[i], view->norm(norm));
+
+            delete view;
+            view = nullptr;
+        }
+    }
+
+    delete batch;
+    delete twice;
+    delete query;
+
+    batch = nullptr;
+    twice = nullptr;
+    query = nullptr;
+
+    return result;
+}
+
+bool testVectorBatchView() {
+    IVectorBatch * batch = IVectorBatch::createBatch(9, DIM, logger);
+    IVector * view = batch->createView(8);
+    IVector * cloned = nullptr;
+    double norms[9];
+    bool result = batch->setVector(8, w) == RESULT_CODE::SUCCESS && numbersEqual(view->getCoord(1), -4.) &&
+            view->setCoord(0, 3.) == RESULT_CODE::SUCCESS && numbersEqual(batch->getCoord(8, 0), 3.) &&
+            IVectorBatch::norm(batch, NORM, norms, logger) == RESULT_CODE::SUCCESS && numbersEqual(norms[8], 5.) &&
+            numbersEqual(norms[0], 0.) && numbersEqual(view->norm(NORM), 5.) && batch->createView(9) == nullptr &&
+            IVectorBatch::mul(batch, INFINITY, batch, logger) == RESULT_CODE::CALCULATION_ERROR &&
+            numbersEqual(batch->getCoord(8, 0), 3.) && numbersEqual(batch->getCoord(8, 1), -4.) &&
+            numbersEqual(batch->getCoord(0, 0), 0.);
+
+    cloned = view->clone();
+    result &= cloned != nullptr && cloned->getData() != nullptr;
+
+    delete cloned;
+    delete view;
+    delete batch;
+
+    cloned = nullptr;
+    view = nullptr;
+    batch = nullptr;
+
+    return result;
+}
+
+void countPair(size_t row, size_t column, double distance, void * pContext) {
+    double * sum = (double *) pContext;
+
+    sum[0] += 1.;
+    sum[1] += row * 1000. + column + distance * 0.;
+}
+
+bool testDistanceMatrix() {
+    size_t const rowsCount = 70, columnsCount = 21, dim = 5;
+    IVectorBatch * rows = IVectorBatch::createBatch(rowsCount, dim, logger);
+    IVectorBatch * columns = IVectorBatch::createBatch(columnsCount, dim, logger);
+    double * matrix = new double[rowsCount * columnsCount];
+    bool result = true;
+
+    for(size_t i = 0; i < rowsCount; ++i) {
+        for(size_t j = 0; j < dim; ++j) {
+            rows->setCoord(i, j, (i * 7 + j * 3) % 11 - 5.);
+
+            if(i < columnsCount) {
+                columns->setCoord(i, j, (i * 5 + j) % 13 - 6.);
+            }
+        }
+    }
+
+    for(IVector::NORM norm : {IVector::NORM::NORM_1, IVector::NORM::NORM_2, IVector::NORM::NORM_INF}) {
+        result &= IVectorBatch::distanceMatrix(rows, columns, norm, matrix, logger) == RESULT_CODE::SUCCESS;
+
+        for(size_t i = 0; i < rowsCount; ++i) {
+            IVector * row = rows->createView(i);
+
+            for(size_t j = 0; j < columnsCount; ++j) {
+                IVector * column = columns->createView(j);
+
+                result &= fabs(matrix[i * columnsCount + j] - IVector::distance(row, column, norm, logger)) < 1e-9;
+
+                delete column;
+                column = nullptr;
+            }
+
+            delete row;
+            row = nullptr;
+        }
+    }
+
+    //the pairs are reported in row-major order: count and checksum of the indices
+    double below[2] = {0., 0.}, above[2] = {0., 0.}, expected[2] = {0., 0.};
+
+    result &= IVectorBatch::selectDistances(rows, columns, IVector::NORM::NORM_INF, 3., true, countPair, below,
+                                            logger) == RESULT_CODE::SUCCESS &&
+            IVectorBatch::selectDistances(rows, columns, IVector::NORM::NORM_INF, 3., false, countPair, above,
+                                          logger) == RESULT_CODE::SUCCESS;
+
+    for(size_t i = 0; i < rowsCount * columnsCount; ++i) {
+        if(matrix[i] <= 3.) {
+            countPair(i / columnsCount, i % columnsCount, matrix[i], expected);
+        }
+    }
+
+    result &= numbersEqual(below[0], expected[0]) && numbersEqual(below[1], expected[1]) &&
+            numbersEqual(below[0] + above[0], rowsCount * columnsCount) &&
+            IVectorBatch::distanceMatrix(rows, nullptr, NORM, matrix, logger) == RESULT_CODE::BAD_REFERENCE;
+
+    //1e-6 apart with norms of 1e4, far below the error of the norms and dot product form
+    IVectorBatch * near = IVectorBatch::createBatch(2, 3, logger);
+    double pairs[2] = {0., 0.}, none[2] = {0., 0.};
+
+    for(size_t j = 0; j < 3; ++j) {
+        near->setCoord(0, j, j == 0 ? 1e4 : j);
+        near->setCoord(1, j, j == 0 ? 1e4 + 1e-6 : j);
+    }
+
+    result &= IVectorBatch::selectDistances(near, near, IVector::NORM::NORM_2, 1.5e-6, true, countPair, pairs,
+                                            logger) == RESULT_CODE::SUCCESS &&
+            IVectorBatch::selectDistances(near, near, IVector::NORM::NORM_2, 0.5e-6, false, countPair, none,
+                                          logger) == RESULT_CODE::SUCCESS &&
+            numbersEqual(pairs[0], 4.) && numbersEqual(none[0], 2.);
+
+    delete near;
+    near = nullptr;
+
+    delete rows;
+    delete columns;
+    delete [] matrix;
+
+    rows = nullptr;
+    columns = nullptr;
+    matrix = nullptr;
+
+    return result;
+}
+
+bool testDistanceMatrixLarge() {
+    size_t const count = 300, dim = 64;
+    IVectorBatch * batch = IVectorBatch::createBatch(count, dim, logger);
+    double * matrix = new double[count * count];
+    bool result = true;
+
+    for(size_t i = 0; i < count; ++i) {
+        for(size_t j = 0; j < dim; ++j) {
+            batch->setCoord(i, j, sin(i * 0.37 + j * 1.3));
+        }
+    }
+
+    result &= IVectorBatch::distanceMatrix(batch, batch, NORM, matrix, logger) == RESULT_CODE::SUCCESS;
+
+    for(size_t i = 0; i < count; i += 13) {
+        IVector * row = batch->createView(i);
+
+        for(size_t j = 0; j < count; ++j) {
+            IVector * column = batch->createView(j);
+
+            result &= fabs(matrix[i * count + j] - IVector::distance(row, column, NORM, logger)) < 1e-6 &&
+                    numbersEqual(matrix[i * count + j], matrix[j * count + i]);
+
+            delete column;
+            column = nullptr;
+        }
+
+        delete row;
+        row = nullptr;
+    }
+
+    delete batch;
+    delete [] matrix;
+
+    batch = nullptr;
+    matrix = nullptr;
+
+    return result;
+}
+
+bool testTrustedVector() {
+    double coords [] = {1., 2., INFINITY};
+    IVector * vector = IVector::createTrustedVector(3, coords, logger);
+    bool result = vector != nullptr && numbersEqual(vector->getCoord(1), 2.) && vector->getData() != coords &&
+            IVector::createTrustedVector(0, coords, logger) == nullptr;
+
+    delete vector;
+    vector = nullptr;
+
+    return result;
+}
+
+bool testHasNaN() {
+    double coords[37] = {0};
+    bool result = !IVector::hasNaN(coords, 37) && !IVector::hasNaN(nullptr, 37);
+
+    for(size_t i = 0; i < 37; ++i) {
+        coords[i] = NAN;
+        result &= IVector::hasNaN(coords, 37) && !IVector::hasNaN(coords, i);
+        coords[i] = INFINITY;
+    }
+
+    return result && !IVector::hasNaN(coords, 37);
+}
+
+bool testSparseVector() {
+    size_t indices [] = {1, 4, 6};
+    size_t unsorted [] = {4, 1, 6};
+    double values [] = {3., -4., 0.};
+    IVector * sparse = IVector::createSparseVector(8, 3, indices, values, logger);
+    bool result = sparse != nullptr && sparse->getData() == nullptr &&
+            IVector::createSparseVector(8, 3, unsorted, values, logger) == nullptr &&
+            IVector::createSparseVector(6, 3, indices, values, logger) == nullptr;
+
+    if(sparse == nullptr) {
+        return false;
+    }
+
+    result &= numbersEqual(sparse->getCoord(4), -4.) && numbersEqual(sparse->getCoord(0), 0.) &&
+            numbersEqual(sparse->norm(IVector::NORM::NORM_2), 5.) && numbersEqual(sparse->norm(IVector::NORM::NORM_1), 7.);
+
+    result &= sparse->setCoord(2, 1.) == RESULT_CODE::SUCCESS && sparse->setCoord(4, 0.) == RESULT_CODE::SUCCESS &&
+            sparse->setCoord(0, NAN) == RESULT_CODE::NAN_VALUE;
+    result &= numbersEqual(sparse->getCoord(2), 1.) && numbersEqual(sparse->norm(IVector::NORM::NORM_INF), 3.);
+
+    size_t otherIndices [] = {2, 7};
+    double otherValues [] = {2., 2.};
+    IVector * other = IVector::createSparseVector(8, 2, otherIndices, otherValues, logger);
+    bool equal = true;
+
+    //{0, 3, 1, 0, 0, 0, 0, 0} and {0, 0, 2, 0, 0, 0, 0, 2}
+    result &= numbersEqual(IVector::mul(sparse, other, logger), 2.) &&
+            numbersEqual(IVector::distance(sparse, other, IVector::NORM::NORM_1, logger), 6.) &&
+            IVector::withinTolerance(sparse, other, IVector::NORM::NORM_INF, 2.5, &equal, logger) == RESULT_CODE::SUCCESS &&
+            !equal;
+
+    result &= IVector::addInPlace(sparse, other, logger) == RESULT_CODE::SUCCESS &&
+            numbersEqual(sparse->getCoord(2), 3.) && numbersEqual(sparse->getCoord(7), 2.) &&
+            IVector::subInPlace(sparse, sparse, logger) == RESULT_CODE::SUCCESS &&
+            numbersEqual(sparse->norm(IVector::NORM::NORM_1), 0.);
+
+    delete sparse;
+    delete other;
+
+    sparse = nullptr;
+    other = nullptr;
+
+    return result;
+}
+
+bool testSparseMixed() {
+    size_t indices [] = {0, 2};
+    double values [] = {1., 2.};
+    double coords [] = {3., 4., 5.};
+    IVector * sparse = IVector::createSparseVector(3, 2, indices, values, logger);
+    IVector * dense = IVector::createVector(3, coords, logger);
+    IVector * sum = IVector::add(dense, sparse, logger);
+    bool equal = false;
+    bool result = sparse != nullptr && dense != nullptr && sum != nullptr;
+
+    if(result) {
+        result &= numbersEqual(IVector::mul(sparse, dense, logger), 13.) &&
+                numbersEqual(IVector::mul(dense, sparse, logger), 13.) &&
+                numbersEqual(IVector::distance(dense, sparse, IVector::NORM::NORM_INF, logger), 4.) &&
+                numbersEqual(sum->getCoord(0), 4.) && numbersEqual(sum->getCoord(1), 4.) &&
+                numbersEqual(sum->getCoord(2), 7.);
+
+        //dense result aliasing the second operand
+        result &= IVector::sub(sparse, dense, dense, logger) == RESULT_CODE::SUCCESS &&
+                numbersEqual(dense->getCoord(0), -2.) && numbersEqual(dense->getCoord(1), -4.) &&
+                numbersEqual(dense->getCoord(2), -3.);
+
+        result &= IVector::axpy(sparse, 1., dense, logger) == RESULT_CODE::SUCCESS &&
+                IVector::equals(sparse, dense, IVector::NORM::NORM_2, 5., &equal, logger) == RESULT_CODE::SUCCESS &&
+                equal && numbersEqual(sparse->getCoord(1), -4.);
+    }
+
+    delete sparse;
+    delete dense;
+    delete sum;
+
+    sparse = nullptr;
+    dense = nullptr;
+    sum = nullptr;
+
+    return result;
+}
+
+bool testDataset() {
+    char const * path = "dataset.bin";
+    double coords [] = {1., 2., 3., 4., 5., 6., 7., 8., 9.};
+    IVectorDatasetWriter * writer = IVectorDatasetWriter::create(path, 3, IVectorDataset::SCALAR::DOUBLE, 128, logger);
+    bool result = writer != nullptr;
+
+    if(writer != nullptr) {
+        double nan [] = {1., NAN, 1.};
+
+        result &= writer->append(coords) == RESULT_CODE::SUCCESS && writer->append(coords + 3) == RESULT_CODE::SUCCESS &&
+                writer->append(v) == RESULT_CODE::WRONG_DIM && writer->append(nan) == RESULT_CODE::NAN_VALUE &&
+                writer->append(coords + 6) == RESULT_CODE::SUCCESS && writer->getCount() == 3 &&
+                writer->close() == RESULT_CODE::SUCCESS && writer->append(coords) == RESULT_CODE::FILE_ERROR;
+    }
+
+    delete writer;
+    writer = nullptr;
+
+    IVectorDataset * dataset = IVectorDataset::open(path, logger);
+
+    result &= dataset != nullptr && IVectorDataset::open("missing.bin", logger) == nullptr;
+
+    if(dataset != nullptr) {
+        IVector * row = dataset->createVector(1);
+        IVectorBatch * batch = dataset->createBatch(1, 2);
+
+        result &= dataset->getCount() == 3 && dataset->getDim() == 3 && dataset->createVector(3) == nullptr &&
+                (size_t) dataset->getData() % 128 == 0 && dataset->createBatch(2, 2) == nullptr;
+        result &= row != nullptr && row->getData() == (double const *) dataset->getData() + 3 &&
+                numbersEqual(row->getCoord(2), 6.) && row->setCoord(0, 0.) != RESULT_CODE::SUCCESS;
+        result &= batch != nullptr && batch->getCount() == 2 && numbersEqual(batch->getCoord(1, 0), 7.);
+
+        delete row;
+        delete batch;
+
+        row = nullptr;
+        batch = nullptr;
+    }
+
+    delete dataset;
+    dataset = nullptr;
+
+    //a NaN written over the second row by something else than the writer
+    FILE * file = std::fopen(path, "r+b");
+    double nan = NAN;
+
+    result &= file != nullptr && std::fseek(file, 128 + 4 * sizeof(double), SEEK_SET) == 0 &&
+            std::fwrite(&nan, sizeof(nan), 1, file) == 1;
+
+    if(file != nullptr) {
+        std::fclose(file);
+        file = nullptr;
+    }
+
+    dataset = IVectorDataset::open(path, logger);
+
+    if(dataset != nullptr) {
+        IVector * row = dataset->createVector(0);
+        IVectorBatch * batch = dataset->createBatch(0, 1);
+
+        result &= row != nullptr && batch != nullptr && dataset->createVector(1) == nullptr &&
+                dataset->createBatch(0, 2) == nullptr;
+
+        delete row;
+        delete batch;
+
+        row = nullptr;
+        batch = nullptr;
+    } else {
+        result = false;
+    }
+
+    delete dataset;
+    dataset = nullptr;
+
+    std::remove(path);
+
+    return result;
+}
+
+bool testFloatDataset() {
+    char const * path = "dataset.bin";
+    IVectorDatasetWriter * writer = IVectorDatasetWriter::create(path, 2, IVectorDataset::SCALAR::FLOAT, 8, logger);
+    bool result = writer != nullptr && IVectorDatasetWriter::create(path, 2, IVectorDataset::SCALAR::FLOAT, 12, logger) == nullptr;
+
+    if(writer != nullptr) {
+        result &= writer->append(v) == RESULT_CODE::SUCCESS;
+    }
+
+    //the count is written by the destructor
+    delete writer;
+    writer = nullptr;
+
+    IVectorDataset * dataset = IVectorDataset::open(path, logger);
+
+    if(dataset != nullptr) {
+        IVector * row = dataset->createVector(0);
+
+        result &= dataset->getCount() == 1 && dataset->getScalarType() == IVectorDataset::SCALAR::FLOAT &&
+                row != nullptr && numbersEqual(row->getCoord(0), v->getCoord(0)) &&
+                numbersEqual(row->getCoord(1), v->getCoord(1));
+
+        delete row;
+        row = nullptr;
+    } else {
+        result = false;
+    }
+
+    delete dataset;
+    dataset = nullptr;
+
+    std::remove(path);
+
+    return result;
+}
+
+bool testParallelKernels() {
+    size_t const BIG_DIM = 100003;
+    size_t threshold = IVector::getParallelThreshold();
+    double * coords = new double[BIG_DIM];
+
+    for(size_t i = 0; i < BIG_DIM; ++i) {
+        coords[i] = sin((double) i);
+    }
+
+    IVector * x = IVector::createVector(BIG_DIM, coords, logger);
+    IVector * y = IVector::mul(x, -0.5, logger);
+    IVector * sum = IVector::add(x, y, logger);
+    bool result = x != nullptr && y != nullptr && sum != nullptr;
+
+    if(result) {
+        double norm = x->norm(IVector::NORM::NORM_2), normInf = x->norm(IVector::NORM::NORM_INF);
+        double dot = IVector::mul(x, y, logger), distance = IVector::distance(x, y, IVector::NORM::NORM_1, logger);
+
+        IVector::setParallelThreshold(1000);
+
+        IVector * parallelSum = IVector::add(x, y, logger);
+
+        result &= fabs(x->norm(IVector::NORM::NORM_2) - norm) <= TOLERANCE * norm &&
+                x->norm(IVector::NORM::NORM_INF) == normInf &&
+                fabs(IVector::mul(x, y, logger) - dot) <= TOLERANCE * fabs(dot) &&
+                fabs(IVector::distance(x, y, IVector::NORM::NORM_1, logger) - distance) <= TOLERANCE * distance;
+        //the same chunks are summed in the same order every time
+        result &= IVector::mul(x, y, logger) == IVector::mul(x, y, logger) &&
+                parallelSum != nullptr && IVector::distance(sum, parallelSum, IVector::NORM::NORM_INF, logger) == 0.;
+
+        delete parallelSum;
+        parallelSum = nullptr;
+
+        IVector::setParallelThreshold(threshold);
+    }
+
+    delete x;
+    delete y;
+    delete sum;
+    delete [] coords;
+
+    x = nullptr;
+    y = nullptr;
+    sum = nullptr;
+    coords = nullptr;
+
+    return result;
+}
+
+bool testCachedNorm() {
+    double coords [] = {3., 4.};
+    IVector * vector = IVector::createVector(2, coords, logger);
+    bool result = vector != nullptr && numbersEqual(vector->norm(IVector::NORM::NORM_2), 5.) &&
+            numbersEqual(vector->norm(IVector::NORM::NORM_2), 5.);
+
+    if(!result) {
+        delete vector;
+
+        return false;
+    }
+
+    IVector * copy = vector->clone();
+
+    //every way of writing drops the cached norms
+    result &= vector->setCoord(0, 0.) == RESULT_CODE::SUCCESS && numbersEqual(vector->norm(IVector::NORM::NORM_2), 4.);
+    vector->getMutableData()[1] = 1.;
+    result &= numbersEqual(vector->norm(IVector::NORM::NORM_1), 1.) && numbersEqual(vector->norm(IVector::NORM::NORM_2), 1.);
+    result &= IVector::scaleInPlace(vector, 3., logger) == RESULT_CODE::SUCCESS &&
+            numbersEqual(vector->norm(IVector::NORM::NORM_INF), 3.);
+    result &= copy != nullptr && numbersEqual(copy->norm(IVector::NORM::NORM_2), 5.);
+
+    delete vector;
+    delete copy;
+
+    vector = nullptr;
+    copy = nullptr;
+
+    return result;
+}
+
+bool testExposedNorm() {
+    size_t const BIG_DIM = 100;
+    double coords[BIG_DIM] = {0};
+    IVector * vector = IVector::createVector(BIG_DIM, coords, logger);
+
+    if(vector == nullptr) {
+        return false;
+    }
+
+    //the pointer is kept across the norm call, the write after it must still be seen
+    double * data = vector->getMutableData();
+    bool result = data != nullptr && numbersEqual(vector->norm(IVector::NORM::NORM_INF), 0.);
+
+    data[0] = 7.;
+    result &= numbersEqual(vector->norm(IVector::NORM::NORM_INF), 7.);
+
+    IVector * copy = vector->clone();
+
+    data[1] = 8.;
+    result &= copy != nullptr && copy->getData() != vector->getData() && numbersEqual(copy->getCoord(1), 0.) &&
+            IVector::addInPlace(vector, copy, logger) == RESULT_CODE::SUCCESS;
+    data[2] = 20.;
+    result &= numbersEqual(vector->norm(IVector::NORM::NORM_INF), 20.);
+
+    delete vector;
+    delete copy;
+
+    vector = nullptr;
+    copy = nullptr;
+
+    return result;
+}
+
+bool testCopyOnWriteClone() {
+    size_t const BIG_DIM = 100;
+    double coords[BIG_DIM] = {0};
+    IVector * vector = IVector::createVector(BIG_DIM, coords, logger);
+    IVector * copy = vector->clone();
+    IVector * copyOfCopy = copy->clone();
+    bool result = copy != nullptr && copyOfCopy != nullptr && copy->getData() == vector->getData() &&
+            copyOfCopy->getData() == vector->getData();
+
+    //the first write gives the written vector coordinates of its own
+    result &= copy->setCoord(0, 1.) == RESULT_CODE::SUCCESS && copy->getData() != vector->getData() &&
+            numbersEqual(vector->getCoord(0), 0.) && numbersEqual(copy->getCoord(0), 1.);
+    result &= IVector::addInPlace(vector, copy, logger) == RESULT_CODE::SUCCESS &&
+            numbersEqual(vector->getCoord(0), 1.) && numbersEqual(copyOfCopy->getCoord(0), 0.);
+
+    //shared coordinates outlive the vector they were created with
+    IVector * shared = vector->clone();
+
+    delete vector;
+    vector = nullptr;
+
+    result &= numbersEqual(shared->getCoord(0), 1.) && shared->getMutableData() != nullptr &&
+            numbersEqual(shared->getCoord(0), 1.);
+
+    IVectorArena * arena = IVectorArena::createArena(4096, logger);
+    IVector * arenaCopy = copyOfCopy->clone(arena);
+
+    result &= arenaCopy != nullptr && arenaCopy->getData() != copyOfCopy->getData();
+
+    delete arenaCopy;
+    delete arena;
+    delete shared;
+    delete copy;
+    delete copyOfCopy;
+
+    arenaCopy = nullptr;
+    arena = nullptr;
+    shared = nullptr;
+    copy = nullptr;
+    copyOfCopy = nullptr;
+
+    return result;
+}
+
+bool testMatrix() {
+    //rotation by a right angle, then a shift by (1, 1)
+    double rotation [] = {0., -1., 1., 0.};
+    double shift [] = {1., 1.};
+    IMatrix * matrix = IMatrix::createMatrix(DIM, DIM, rotation, shift, logger);
+    IMatrix * twice = IMatrix::mul(matrix, matrix, logger);
+    IVector * moved = IMatrix::mul(matrix, v, logger);
+    IVector * movedTwice = IMatrix::mul(twice, v, logger);
+    bool result = moved != nullptr && numbersEqual(moved->getCoord(0), -1.) && numbersEqual(moved->getCoord(1), 2.) &&
+            movedTwice != nullptr && numbersEqual(movedTwice->getCoord(0), -1.) &&
+            numbersEqual(movedTwice->getCoord(1), 0.);
+
+    IVector * shorter = IVector::createVector(1, vCoords, logger);
+
+    result &= IMatrix::mul(matrix, shorter, logger) == nullptr &&
+            matrix->setCoord(0, 0, numeric_limits <double>::quiet_NaN()) == RESULT_CODE::NAN_VALUE;
+
+    delete shorter;
+    delete matrix;
+    delete twice;
+    delete moved;
+    delete movedTwice;
+
+    shorter = nullptr;
+    matrix = nullptr;
+    twice = nullptr;
+    moved = nullptr;
+    movedTwice = nullptr;
+
+    return result;
+}
+
+bool testMatrixBatch() {
+    size_t const count = 11, rows = 5, cols = 3;
+    double coords[rows * cols], shift[rows];
+    IVectorBatch * batch = IVectorBatch::createBatch(count, cols, logger);
+    IVectorBatch * projected = IVectorBatch::createBatch(count, rows, logger);
+    bool result = true;
+
+    for(size_t i = 0; i < rows * cols; ++i) {
+        coords[i] = i % 4 - 1.5;
+    }
+
+    for(size_t i = 0; i < rows; ++i) {
+        shift[i] = i;
+    }
+
+    for(size_t i = 0; i < count; ++i) {
+        for(size_t j = 0; j < cols; ++j) {
+            batch->setCoord(i, j, i * 0.5 - j);
+        }
+    }
+
+    IMatrix * matrix = IMatrix::createMatrix(rows, cols, coords, shift, logger);
+    IMatrix * square = IMatrix::createMatrix(cols, cols, coords, nullptr, logger);
+    IVectorBatch * transformed = batch->clone();
+
+    result &= IMatrix::mul(matrix, batch, projected, logger) == RESULT_CODE::SUCCESS &&
+            IMatrix::transform(square, transformed, logger) == RESULT_CODE::SUCCESS &&
+            IMatrix::transform(matrix, transformed, logger) == RESULT_CODE::WRONG_DIM;
+
+    for(size_t i = 0; i < count; ++i) {
+        IVector * view = batch->createView(i);
+        IVector * expected = IMatrix::mul(matrix, view, logger);
+        IVector * expectedSquare = IMatrix::mul(square, view, logger);
+
+        for(size_t j = 0; j < rows; ++j) {
+            result &= numbersEqual(projected->getCoord(i, j), expected->getCoord(j));
+        }
+
+        for(size_t j = 0; j < cols; ++j) {
+            result &= numbersEqual(transformed->getCoord(i, j), expectedSquare->getCoord(j));
+        }
+
+        delete view;
+        delete expected;
+        delete expectedSquare;
+    }
+
+    //unused lanes of the last block stay zero
+    result &= projected->getData()[(count / IVectorBatch::LANES * rows + rows - 1) * IVectorBatch::LANES + 7] == 0.;
+
+    //the first vector has zero first coordinate, which the infinite column multiplies
+    for(size_t i = 0; i < rows * cols; ++i) {
+        coords[i] = i % cols == 0 ? numeric_limits <double>::infinity() : 1.;
+    }
+
+    IMatrix * huge = IMatrix::createMatrix(cols, cols, coords, nullptr, logger);
+    IMatrix * hugeProjection = IMatrix::createMatrix(rows, cols, coords, nullptr, logger);
+    IVectorBatch * before = batch->clone();
+    IVectorBatch * projectedBefore = projected->clone();
+
+    result &= IMatrix::transform(huge, batch, logger) == RESULT_CODE::CALCULATION_ERROR &&
+            IMatrix::mul(hugeProjection, batch, projected, logger) == RESULT_CODE::CALCULATION_ERROR;
+
+    for(size_t i = 0; i < count; ++i) {
+        for(size_t j = 0; j < cols; ++j) {
+            result &= batch->getCoord(i, j) == before->getCoord(i, j);
+        }
+
+        for(size_t j = 0; j < rows; ++j) {
+            result &= projected->getCoord(i, j) == projectedBefore->getCoord(i, j);
+        }
+    }
+
+    delete huge;
+    delete hugeProjection;
+    delete before;
+    delete projectedBefore;
+    delete matrix;
+    delete square;
+    delete batch;
+    delete projected;
+    delete transformed;
+
+    huge = nullptr;
+    hugeProjection = nullptr;
+    before = nullptr;
+    projectedBefore = nullptr;
+    matrix = nullptr;
+    square = nullptr;
+    batch = nullptr;
+    projected = nullptr;
+    transformed = nullptr;
+
+    return result;
+}
+
+bool testWeightedNorm() {
+    //differences of v and w are (4, 6), scaled to (8, 3)
+    double weights [] = {2., 0.5};
+    INorm * weighted = INorm::createWeightedNorm(2., DIM, weights, logger);
+    INorm * weightedInf = INorm::createWeightedNorm(numeric_limits <double>::infinity(), DIM, weights, logger);
+    INorm * cube = INorm::createNorm(3., logger);
+    INorm * euclidean = INorm::createNorm(2., logger);
+    INorm * wrongDim = INorm::createWeightedNorm(2., 3, wCoords, logger);
+    bool result = INorm::createNorm(0.5, logger) == nullptr && wrongDim == nullptr;
+    bool within = false;
+
+    result &= numbersEqual(IVector::distance(v, w, weighted, logger), sqrt(73.)) &&
+            numbersEqual(IVector::distance(v, w, weightedInf, logger), 8.) &&
+            numbersEqual(IVector::distance(v, w, cube, logger), cbrt(280.)) &&
+            numbersEqual(IVector::distance(v, w, euclidean, logger), IVector::distance(v, w, NORM, logger)) &&
+            numbersEqual(weighted->norm(v), sqrt(5.));
+
+    result &= IVector::withinTolerance(v, w, weighted, 8.55, &within, logger) == RESULT_CODE::SUCCESS && within &&
+            IVector::withinTolerance(v, w, weighted, 8.54, &within, logger) == RESULT_CODE::SUCCESS && !within &&
+            IVector::equals(v, w, cube, 6.55, &within, logger) == RESULT_CODE::SUCCESS && within;
+
+    //vectors longer than one kernel call, stored in single precision so that the coordinates are read one by one
+    size_t const BIG_DIM = 3000;
+    double bigWeights[BIG_DIM], coords[BIG_DIM];
+    float floatCoords[BIG_DIM];
+
+    for(size_t i = 0; i < BIG_DIM; ++i) {
+        bigWeights[i] = i % 3;
+        coords[i] = (i % 7) * 0.25;
+        floatCoords[i] = (float) (i % 5);
+    }
+
+    INorm * bigWeighted = INorm::createWeightedNorm(1., BIG_DIM, bigWeights, logger);
+    IVector * big = IVector::createVector(BIG_DIM, coords, logger);
+    IVector * bigFloat = IVector::createFloatVector(BIG_DIM, floatCoords, logger);
+    double expected = 0.;
+
+    for(size_t i = 0; i < BIG_DIM; ++i) {
+        expected += bigWeights[i] * fabs(coords[i] - floatCoords[i]);
+    }
+
+    result &= numbersEqual(IVector::distance(big, bigFloat, bigWeighted, logger), expected) &&
+            IVector::withinTolerance(big, bigFloat, bigWeighted, expected * 0.999, &within, logger) ==
+            RESULT_CODE::SUCCESS && !within &&
+            IVector::withinTolerance(big, v, bigWeighted, 1., &within, logger) == RESULT_CODE::WRONG_DIM;
+
+    //powers of the differences underflow or overflow, but the norms do not
+    double tinyCoords[] = {1e-10, 0.}, tinierCoords[] = {1e-170, 0.}, hugeCoords[] = {1e11, -1e11};
+    double zeroCoords[] = {0., 0.}, ones[] = {1., 1.};
+    INorm * high = INorm::createNorm(40., logger);
+    INorm * unitWeighted = INorm::createWeightedNorm(2., DIM, ones, logger);
+    IVector * tiny = IVector::createVector(DIM, tinyCoords, logger);
+    IVector * huge = IVector::createVector(DIM, hugeCoords, logger);
+    IVector * zero = IVector::createVector(DIM, zeroCoords, logger);
+    IVector * tinier = IVector::createVector(DIM, tinierCoords, logger);
+
+    result &= numbersEqual(IVector::distance(tiny, zero, high, logger), 1e-10) &&
+            numbersEqual(IVector::distance(huge, zero, high, logger), 1e11 * pow(2., 1. / 40.)) &&
+            numbersEqual(high->norm(huge) / 1e11, pow(2., 1. / 40.)) &&
+            numbersEqual(unitWeighted->norm(tinier) / 1e-170, 1.) &&
+            IVector::withinTolerance(tiny, zero, high, 1e-11, &within, logger) == RESULT_CODE::SUCCESS && !within &&
+            IVector::withinTolerance(tiny, zero, high, 2e-10, &within, logger) == RESULT_CODE::SUCCESS && within &&
+            IVector::withinTolerance(huge, zero, high, 1e10, &within, logger) == RESULT_CODE::SUCCESS && !within &&
+            IVector::withinTolerance(huge, zero, high, 1.1e11, &within, logger) == RESULT_CODE::SUCCESS && within &&
+            IVector::withinTolerance(tinier, zero, unitWeighted, 1e-171, &within, logger) == RESULT_CODE::SUCCESS &&
+            !within;
+
+    delete high;
+    delete unitWeighted;
+    delete tiny;
+    delete huge;
+    delete zero;
+    delete tinier;
+    delete weighted;
+    delete weightedInf;
+    delete cube;
+    delete euclidean;
+    delete bigWeighted;
+    delete big;
+    delete bigFloat;
+
+    weighted = nullptr;
+    weightedInf = nullptr;
+    cube = nullptr;
+    euclidean = nullptr;
+    bigWeighted = nullptr;
+    big = nullptr;
+    bigFloat = nullptr;
+    high = nullptr;
+    unitWeighted = nullptr;
+    tiny = nullptr;
+    huge = nullptr;
+    zero = nullptr;
+    tinier = nullptr;
+
+    return result;
+}
+
+bool testQuantizedBatch() {
+    //a dimension with a tail after the widest kernel blocks
+    size_t const COUNT = 20, BIG_DIM = 37;
+    IVector::NORM const NORMS [] = {IVector::NORM::NORM_1, IVector::NORM::NORM_2, IVector::NORM::NORM_INF};
+    IVector * vectors[COUNT];
+    double coords[BIG_DIM];
+    bool result = IQuantizedBatch::createBatch(COUNT, 0, IQuantizedBatch::CODE::INT8, logger) == nullptr;
+
+    for(size_t i = 0; i < COUNT; ++i) {
+        for(size_t j = 0; j < BIG_DIM; ++j) {
+            coords[j] = sin(i * 7. + j) * (i + 1.) - 0.5 * i;
+        }
+
+        vectors[i] = IVector::createVector(BIG_DIM, coords, logger);
+    }
+
+    //close to vector 3 in every norm
+    for(size_t j = 0; j < BIG_DIM; ++j) {
+        coords[j] = vectors[3]->getCoord(j) + (j % 2 == 0 ? 0.001 : -0.001);
+    }
+
+    IVector * query = IVector::createVector(BIG_DIM, coords, logger);
+
+    for(IQuantizedBatch::CODE code : {IQuantizedBatch::CODE::INT8, IQuantizedBatch::CODE::INT16}) {
+        IQuantizedBatch * batch = IQuantizedBatch::createBatch(COUNT, BIG_DIM, code, logger);
+        double distances[COUNT];
+        size_t indices[COUNT], count = 0;
+
+        for(size_t i = 0; i < COUNT; ++i) {
+            result &= batch->setVector(i, vectors[i]) == RESULT_CODE::SUCCESS;
+
+            for(size_t j = 0; j < BIG_DIM; ++j) {
+                result &= fabs(batch->getCoord(i, j) - vectors[i]->getCoord(j)) <= batch->getScale(i) * 0.5 + 1e-12;
+            }
+        }
+
+        IQuantizedBatch * copy = batch->clone();
+        IVector * decoded = copy->createVector(5);
+
+        result &= numbersEqual(IVector::distance(decoded, vectors[5], IVector::NORM::NORM_2, logger),
+                               batch->getError(5, IVector::NORM::NORM_2));
+
+        for(IVector::NORM norm : NORMS) {
+            result &= IQuantizedBatch::distance(batch, query, norm, distances, logger) == RESULT_CODE::SUCCESS &&
+                    IQuantizedBatch::filter(batch, query, norm, 0.05 * BIG_DIM, indices, &count, logger) ==
+                    RESULT_CODE::SUCCESS && count > 0 && count < COUNT;
+
+            //no vector within tolerance is filtered out
+            for(size_t i = 0, candidate = 0; i < COUNT; ++i) {
+                bool equal = false;
+
+                IVector::equals(vectors[i], query, norm, 0.05 * BIG_DIM, &equal, logger);
+                result &= fabs(distances[i] - IVector::distance(vectors[i], query, norm, logger)) <=
+                        batch->getError(i, norm) + 1e-9;
+
+                if(candidate < count && indices[candidate] == i) {
+                    ++candidate;
+                } else {
+                    result &= !equal;
+                }
+            }
+        }
+
+        result &= IQuantizedBatch::distance(batch, v, NORM, distances, logger) == RESULT_CODE::WRONG_DIM &&
+                batch->setVector(COUNT, query) == RESULT_CODE::OUT_OF_BOUNDS;
+
+        delete batch;
+        delete copy;
+        delete decoded;
+
+        batch = nullptr;
+        copy = nullptr;
+        decoded = nullptr;
+    }
+
+    for(size_t i = 0; i < COUNT; ++i) {
+        delete vectors[i];
+        vectors[i] = nullptr;
+    }
+
+    delete query;
+    query = nullptr;
+
+    return result;
+}
+
+bool testVectorPool() {
+    IVectorPool * pool = IVectorPool::createPool(logger);
+    double corner [] = {1., 2.};
+    float floatCorner [] = {1.f, 2.f};
+    double nanCoords [] = {1., numeric_limits <double>::quiet_NaN()};
+    IVector * floatVector = IVector::createFloatVector(DIM, floatCorner, logger);
+    IVector const * interned = pool->intern(DIM, corner);
+    bool equal = false;
+    bool result = interned != nullptr && pool->intern(v) == interned && pool->intern(floatVector) == interned &&
+            pool->intern(w) != interned && pool->intern(w) == pool->intern(w) && pool->getCount() == 2 &&
+            pool->intern(DIM, nanCoords) == nullptr && pool->intern(nullptr) == nullptr;
+
+    //clones of short interned vectors copy their few coordinates
+    IVector * smallClone = interned->clone();
+
+    result &= smallClone->getData() != interned->getData() && smallClone->getCoord(1) == 2.;
+
+    //-0.0 is equal to 0.0, so both get the same vector
+    double zero [] = {0., 1.};
+    double negativeZero [] = {-0., 1.};
+    IVector * negativeVector = IVector::createVector(DIM, negativeZero, logger);
+    IVector const * zeroInterned = pool->intern(DIM, zero);
+
+    result &= zeroInterned != nullptr && pool->intern(DIM, negativeZero) == zeroInterned &&
+            pool->intern(negativeVector) == zeroInterned && !std::signbit(zeroInterned->getCoord(0));
+
+    //enough vectors to grow the table, and long ones whose clones share the interned coordinates
+    size_t const BIG_DIM = 100, COUNT = 300;
+    double coords[BIG_DIM] = {};
+    IVector const * first = nullptr;
+
+    for(size_t i = 0; i < COUNT; ++i) {
+        coords[i % BIG_DIM] += 1.;
+
+        IVector const * vector = pool->intern(BIG_DIM, coords);
+
+        first = i == 0 ? vector : first;
+        result &= vector != nullptr && pool->intern(vector) == vector;
+    }
+
+    for(size_t j = 0; j < BIG_DIM; ++j) {
+        coords[j] = j == 0 ? 1. : 0.;
+    }
+
+    IVector * clone = pool->intern(BIG_DIM, coords)->clone();
+
+    result &= pool->getCount() == COUNT + 3 && pool->intern(BIG_DIM, coords) == first &&
+            clone->getData() == first->getData() &&
+            IVector::equals(clone, first, NORM, 0., &equal, logger) == RESULT_CODE::SUCCESS && equal &&
+            IVector::withinTolerance(first, first, NORM, 0., &equal, logger) == RESULT_CODE::SUCCESS && equal;
+
+    pool->clear();
+    result &= pool->getCount() == 0 && clone->getCoord(0) == 1.;
+
+    delete pool;
+    delete floatVector;
+    delete clone;
+    delete smallClone;
+    delete negativeVector;
+
+    pool = nullptr;
+    floatVector = nullptr;
+    clone = nullptr;
+    smallClone = nullptr;
+    negativeVector = nullptr;
+
+    return result;
+}
+
 bool testGetDim() {
     size_t dim = v->getDim();
     double correctDim = 2;
@@ -278,17 +1776,62 @@ int main() {
     test("testMulScalar", testMulScalar);
     test("testMulScalarNan", testMulScalarNan);
     test("testMul", testMul);
+    test("testAddInPlace", testAddInPlace);
+    test("testSubInPlace", testSubInPlace);
+    test("testScaleInPlace", testScaleInPlace);
+    test("testAxpy", testAxpy);
+    test("testInPlaceNaN", testInPlaceNaN);
+    test("testSubToResult", testSubToResult);
+    test("testAddToResultDim", testAddToResultDim);
+    test("testDistance", testDistance);
+    test("testDistanceDim", testDistanceDim);
     test("testEquals", testEquals);
     test("testNotEquals", testNotEquals);
+    test("testWithinTolerance", testWithinTolerance);
+    test("testWithinToleranceNegative", testWithinToleranceNegative);
     test("testClone", testClone);
+    test("testCloneDims", testCloneDims);
+    test("testArena", testArena);
+    test("testArenaChunkSize", testArenaChunkSize);
     test("testGetCoord", testGetCoord);
     test("testGetCoordIndex", testGetCoordIndex);
+    test("testGetData", testGetData);
+    test("testGetMutableData", testGetMutableData);
     test("testCreateVectorDim", testCreateVectorDim);
     test("testSetCoord", testSetCoord);
     test("testSetCoordIndex", testSetCoordIndex);
     test("testSetCoordNaN", testSetCoordNaN);
     test("testNorm", testNorm);
     test("testGetDim", testGetDim);
+    test("testSelfTest", testSelfTest);
+    test("testNormLarge", testNormLarge);
+    test("testFloatVector", testFloatVector);
+    test("testFloatVectorNaN", testFloatVectorNaN);
+    test("testFixedVector", testFixedVector);
+    test("testFixedVectorAdapter", testFixedVectorAdapter);
+    test("testView", testView);
+    test("testReadOnlyView", testReadOnlyView);
+    test("testVectorExpr", testVectorExpr);
+    test("testVectorExprInvalid", testVectorExprInvalid);
+    test("testVectorBatch", testVectorBatch);
+    test("testVectorBatchView", testVectorBatchView);
+    test("testDistanceMatrix", testDistanceMatrix);
+    test("testDistanceMatrixLarge", testDistanceMatrixLarge);
+    test("testTrustedVector", testTrustedVector);
+    test("testHasNaN", testHasNaN);
+    test("testSparseVector", testSparseVector);
+    test("testSparseMixed", testSparseMixed);
+    test("testDataset", testDataset);
+    test("testFloatDataset", testFloatDataset);
+    test("testParallelKernels", testParallelKernels);
+    test("testCachedNorm", testCachedNorm);
+    test("testExposedNorm", testExposedNorm);
+    test("testCopyOnWriteClone", testCopyOnWriteClone);
+    test("testMatrix", testMatrix);
+    test("testMatrixBatch", testMatrixBatch);
+    test("testWeightedNorm", testWeightedNorm);
+    test("testQuantizedBatch", testQuantizedBatch);
+    test("testVectorPool", testVectorPool);
 
     if(passed) {
         cout << "\nAll tests PASSED\n";
@@ -15,6 +15,15 @@ DISTFILES += \
     libs/vector.dll
 
 HEADERS += \
+    include/FixedVector.h \
     include/ILogger.h \
+    include/IMatrix.h \
+    include/INorm.h \
+    include/IQuantizedBatch.h \
     include/IVector.h \
-    include/RC.h
+    include/IVectorArena.h \
+    include/IVectorBatch.h \
+    include/IVectorDataset.h \
+    include/IVectorPool.h \
+    include/RC.h \
+    include/VectorExpr.h
@@ -5,6 +5,9 @@ DEFINES += VECTOR_LIBRARY
 
 CONFIG += c++11
 
+# asserts guard trusted fast paths in debug builds only
+CONFIG(release, debug|release): DEFINES += NDEBUG
+
 # The following define makes your compiler emit warnings if you use
 # any Qt feature that has been marked deprecated (the exact warnings
 # depend on your compiler). Please consult the documentation of the
@@ -15,15 +18,41 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
-SOURCES += src/Vector.cpp
+SOURCES += \
+    src/DistanceMatrix.cpp \
+    src/Kernels.cpp \
+    src/Loggable.cpp \
+    src/Matrix.cpp \
+    src/Norm.cpp \
+    src/QuantizedBatch.cpp \
+    src/SparseVector.cpp \
+    src/Vector.cpp \
+    src/VectorArena.cpp \
+    src/VectorBatch.cpp \
+    src/VectorDataset.cpp \
+    src/VectorPool.cpp \
+    src/WorkerPool.cpp
 
 LIBS += \
     -L$$PWD/libs/ -llogger
 
 HEADERS += \
+    include/FixedVector.h \
     include/ILogger.h \
+    include/IMatrix.h \
+    include/INorm.h \
+    include/IQuantizedBatch.h \
     include/IVector.h \
-    include/RC.h
+    include/IVectorArena.h \
+    include/IVectorBatch.h \
+    include/IVectorDataset.h \
+    include/IVectorPool.h \
+    include/RC.h \
+    include/VectorExpr.h \
+    src/Kernels.h \
+    src/Loggable.h \
+    src/SparseVector.h \
+    src/WorkerPool.h
 
 # Default rules for deployment.
 unix {